@@ -19,16 +19,67 @@ win32 {
     LIBS += -luser32 -lDwmapi -lGdi32
 }
 
+# Lets the maximize animation ask X11 whether a compositor is running,
+# without it the state changes instantly there.
+unix:!macx:qtHaveModule(x11extras) {
+    QT += x11extras
+    DEFINES += FRAMELESS_X11EXTRAS
+}
+
+# Heap accounting for --memory-check, replaces malloc on glibc.
+alloc_counter {
+    DEFINES += FRAMELESS_COUNT_ALLOCATIONS
+}
+
 SOURCES += \
+    allocationcounter.cpp \
+    animationclock.cpp \
+    backdropblur.cpp \
+    chromecounters.cpp \
+    chromediagnostics.cpp \
+    chrometrace.cpp \
+    framelesshelper.cpp \
     framelesswidget.cpp \
+    framelesswindow.cpp \
+    inputtrace.cpp \
     main.cpp \
+    sessionstate.cpp \
+    snapshottransition.cpp \
     titlebar.cpp \
-    titlebarbutton.cpp
+    titlebarbutton.cpp \
+    titlebarglyphs.cpp \
+    titlebartabstrip.cpp
 
 HEADERS += \
+    allocationcounter.h \
+    animationclock.h \
+    backdropblur.h \
+    chromecounters.h \
+    chromediagnostics.h \
+    chrometrace.h \
+    framelesshelper.h \
     framelesswidget.h \
+    framelesswindow.h \
+    inputtrace.h \
+    sessionstate.h \
+    snapshottransition.h \
     titlebar.h \
-    titlebarbutton.h
+    titlebarbutton.h \
+    titlebarglyphs.h \
+    titlebartabstrip.h
+
+# QML variant of the demo window for --quick, only built with
+# CONFIG+=quick_demo so the widget demo doesn't depend on QtQuick.
+quick_demo {
+    QT += qml quick
+    DEFINES += FRAMELESS_QUICK
+    SOURCES += \
+        framelessquickwindow.cpp \
+        titlebarbuttonitem.cpp
+    HEADERS += \
+        framelessquickwindow.h \
+        titlebarbuttonitem.h
+}
 
 FORMS +=
 
@@ -0,0 +1,114 @@
+#include "allocationcounter.h"
+
+#if defined(FRAMELESS_COUNT_ALLOCATIONS) && defined(__GLIBC__)
+#include <errno.h>
+#include <malloc.h>
+#include <stdlib.h>
+
+#include <atomic>
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void __libc_free(void *ptr);
+}
+
+static std::atomic<qint64> g_allocations(0);
+static std::atomic<qint64> g_liveBytes(0);
+
+static void *countAllocation(void *ptr)
+{
+    if (ptr)
+    {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        g_liveBytes.fetch_add(
+            malloc_usable_size(ptr), std::memory_order_relaxed);
+    }
+    return ptr;
+}
+
+// glibc declares these as __THROW, the replacements have to match.
+extern "C" void *malloc(size_t size) __THROW
+{
+    return countAllocation(__libc_malloc(size));
+}
+
+extern "C" void *calloc(size_t count, size_t size) __THROW
+{
+    return countAllocation(__libc_calloc(count, size));
+}
+
+extern "C" void *realloc(void *ptr, size_t size) __THROW
+{
+    const qint64 oldSize = ptr ? malloc_usable_size(ptr) : 0;
+    void *result = __libc_realloc(ptr, size);
+    if (!result)
+    {
+        // realloc(ptr, 0) may free the block and return null
+        if (size == 0)
+            g_liveBytes.fetch_sub(oldSize, std::memory_order_relaxed);
+        return result;
+    }
+
+    // Only growth asks the heap for memory, a shrinking realloc is not an
+    // allocation.
+    const qint64 newSize = malloc_usable_size(result);
+    g_liveBytes.fetch_add(newSize - oldSize, std::memory_order_relaxed);
+    if (newSize > oldSize)
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+    return result;
+}
+
+extern "C" void *memalign(size_t alignment, size_t size) __THROW
+{
+    return countAllocation(__libc_memalign(alignment, size));
+}
+
+extern "C" void *aligned_alloc(size_t alignment, size_t size) __THROW
+{
+    return countAllocation(__libc_memalign(alignment, size));
+}
+
+extern "C" int posix_memalign(void **ptr, size_t alignment, size_t size) __THROW
+{
+    void *result = countAllocation(__libc_memalign(alignment, size));
+    if (!result)
+        return ENOMEM;
+
+    *ptr = result;
+    return 0;
+}
+
+extern "C" void free(void *ptr) __THROW
+{
+    if (ptr)
+        g_liveBytes.fetch_sub(
+            malloc_usable_size(ptr), std::memory_order_relaxed);
+    __libc_free(ptr);
+}
+
+bool isAllocationCountingEnabled()
+{
+    return true;
+}
+
+AllocationStats allocationStats()
+{
+    AllocationStats stats;
+    stats.allocations = g_allocations.load(std::memory_order_relaxed);
+    stats.liveBytes = g_liveBytes.load(std::memory_order_relaxed);
+    return stats;
+}
+#else
+bool isAllocationCountingEnabled()
+{
+    return false;
+}
+
+AllocationStats allocationStats()
+{
+    return AllocationStats();
+}
+#endif
@@ -0,0 +1,19 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+struct AllocationStats
+{
+    // malloc, calloc and the aligned variants, plus reallocs that grow a
+    // block
+    qint64 allocations = 0;
+    qint64 liveBytes = 0;
+};
+
+// Heap accounting is only compiled in with CONFIG+=alloc_counter and needs
+// glibc, where malloc and friends can be replaced by the executable.
+bool isAllocationCountingEnabled();
+AllocationStats allocationStats();
+
+#endif  // ALLOCATIONCOUNTER_H
@@ -0,0 +1,64 @@
+#include "animationclock.h"
+
+#include <QTimerEvent>
+
+constexpr int kFrameInterval = 16;
+
+AnimationClock *AnimationClock::instance()
+{
+    static AnimationClock clock;
+    return &clock;
+}
+
+AnimationClock::AnimationClock()
+{
+    m_elapsed.start();
+}
+
+qint64 AnimationClock::now() const
+{
+    return m_elapsed.elapsed();
+}
+
+bool AnimationClock::isActive() const
+{
+    return m_timer.isActive();
+}
+
+void AnimationClock::start(ClockedAnimation *animation)
+{
+    if (!m_animations.contains(animation))
+        m_animations.append(animation);
+
+    if (!m_timer.isActive())
+        m_timer.start(kFrameInterval, Qt::PreciseTimer, this);
+}
+
+void AnimationClock::stop(ClockedAnimation *animation)
+{
+    m_animations.removeOne(animation);
+    if (m_animations.isEmpty())
+        m_timer.stop();
+}
+
+void AnimationClock::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() != m_timer.timerId())
+    {
+        QObject::timerEvent(event);
+        return;
+    }
+
+    const qint64 msecs = now();
+    int active = 0;
+    for (int i = 0; i < m_animations.size(); ++i)
+    {
+        ClockedAnimation *animation = m_animations.at(i);
+        if (animation->advance(msecs))
+            m_animations[active++] = animation;
+    }
+    m_animations.resize(active);
+
+    if (m_animations.isEmpty())
+        m_timer.stop();
+}
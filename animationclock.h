@@ -0,0 +1,45 @@
+#ifndef ANIMATIONCLOCK_H
+#define ANIMATIONCLOCK_H
+
+#include <QBasicTimer>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QVector>
+
+class ClockedAnimation
+{
+public:
+    virtual ~ClockedAnimation() = default;
+
+    // Steps the animation to |msecs| on the clock, returns false once the
+    // animation has finished.
+    virtual bool advance(qint64 msecs) = 0;
+};
+
+// One clock for all chrome animations of the process. It only ticks while at
+// least one animation is running and steps all of them in the same tick.
+class AnimationClock : public QObject
+{
+    Q_OBJECT
+public:
+    static AnimationClock *instance();
+
+    qint64 now() const;
+    bool isActive() const;
+
+    void start(ClockedAnimation *animation);
+    void stop(ClockedAnimation *animation);
+
+protected:
+    virtual void timerEvent(QTimerEvent *event) override;
+
+private:
+    AnimationClock();
+
+private:
+    QBasicTimer m_timer;
+    QElapsedTimer m_elapsed;
+    QVector<ClockedAnimation *> m_animations;
+};
+
+#endif  // ANIMATIONCLOCK_H
@@ -0,0 +1,322 @@
+#include "backdropblur.h"
+
+#include <cstring>
+#include <vector>
+
+// MSVC has no __SSE2__, SSE2 is always there on x64 and with /arch:SSE2
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BACKDROP_BLUR_SSE2
+#include <emmintrin.h>
+#endif
+
+#include <QtGlobal>
+
+constexpr int kBlurPasses = 3;
+constexpr int kTileSize = 128;
+
+// The running sums are kept as four floats per pixel, one per channel. They
+// only ever hold integers below 2^24, so adding and removing pixels is exact.
+#ifdef BACKDROP_BLUR_SSE2
+inline __m128 unpackPixel(quint32 pixel)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i v = _mm_cvtsi32_si128(static_cast<int>(pixel));
+    v = _mm_unpacklo_epi8(v, zero);
+    v = _mm_unpacklo_epi16(v, zero);
+    return _mm_cvtepi32_ps(v);
+}
+
+inline void seedSum(float *sum, quint32 pixel, float weight)
+{
+    _mm_storeu_ps(sum, _mm_mul_ps(unpackPixel(pixel), _mm_set1_ps(weight)));
+}
+
+inline void addToSum(float *sum, quint32 pixel)
+{
+    _mm_storeu_ps(sum, _mm_add_ps(_mm_loadu_ps(sum), unpackPixel(pixel)));
+}
+
+inline void slideSum(float *sum, quint32 added, quint32 removed)
+{
+    __m128 v = _mm_loadu_ps(sum);
+    v = _mm_add_ps(v, _mm_sub_ps(unpackPixel(added), unpackPixel(removed)));
+    _mm_storeu_ps(sum, v);
+}
+
+inline quint32 averageSum(const float *sum, float scale)
+{
+    __m128i v =
+        _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(sum), _mm_set1_ps(scale)));
+    v = _mm_packs_epi32(v, v);
+    v = _mm_packus_epi16(v, v);
+    return static_cast<quint32>(_mm_cvtsi128_si32(v));
+}
+#else
+inline void seedSum(float *sum, quint32 pixel, float weight)
+{
+    for (int c = 0; c < 4; ++c)
+        sum[c] = ((pixel >> (8 * c)) & 0xff) * weight;
+}
+
+inline void addToSum(float *sum, quint32 pixel)
+{
+    for (int c = 0; c < 4; ++c)
+        sum[c] += (pixel >> (8 * c)) & 0xff;
+}
+
+inline void slideSum(float *sum, quint32 added, quint32 removed)
+{
+    for (int c = 0; c < 4; ++c)
+    {
+        sum[c] += static_cast<int>((added >> (8 * c)) & 0xff) -
+                  static_cast<int>((removed >> (8 * c)) & 0xff);
+    }
+}
+
+inline quint32 averageSum(const float *sum, float scale)
+{
+    quint32 pixel = 0;
+    for (int c = 0; c < 4; ++c)
+    {
+        const quint32 value = qBound(0, qRound(sum[c] * scale), 255);
+        pixel |= value << (8 * c);
+    }
+    return pixel;
+}
+#endif
+
+// Box blur of one row, pixels outside the row repeat the edge pixel.
+void blurRow(const quint32 *src, quint32 *dst, int length, int radius)
+{
+    const float scale = 1.0f / (2 * radius + 1);
+    const int last = length - 1;
+    float sum[4];
+    seedSum(sum, src[0], radius + 1);
+    for (int i = 1; i <= radius; ++i)
+        addToSum(sum, src[qMin(i, last)]);
+
+    for (int i = 0; i < length; ++i)
+    {
+        dst[i] = averageSum(sum, scale);
+        slideSum(
+            sum, src[qMin(i + radius + 1, last)], src[qMax(i - radius, 0)]);
+    }
+}
+
+void blurHorizontal(const QImage &src, QImage &dst, int radius)
+{
+    const int width = src.width();
+    for (int y = 0; y < src.height(); ++y)
+    {
+        blurRow(
+            reinterpret_cast<const quint32 *>(src.constScanLine(y)),
+            reinterpret_cast<quint32 *>(dst.scanLine(y)), width, radius);
+    }
+}
+
+// The vertical pass walks the image row by row and keeps one running sum per
+// column, so memory is always read contiguously instead of column-wise.
+void blurVertical(const QImage &src, QImage &dst, int radius)
+{
+    const int width = src.width();
+    const int last = src.height() - 1;
+    const float scale = 1.0f / (2 * radius + 1);
+    std::vector<float> sums(4 * width);
+
+    auto row = [&src](int y) {
+        return reinterpret_cast<const quint32 *>(src.constScanLine(y));
+    };
+
+    const quint32 *first = row(0);
+    for (int x = 0; x < width; ++x)
+        seedSum(&sums[4 * x], first[x], radius + 1);
+    for (int i = 1; i <= radius; ++i)
+    {
+        const quint32 *line = row(qMin(i, last));
+        for (int x = 0; x < width; ++x)
+            addToSum(&sums[4 * x], line[x]);
+    }
+
+    for (int y = 0; y <= last; ++y)
+    {
+        quint32 *out = reinterpret_cast<quint32 *>(dst.scanLine(y));
+        const quint32 *added = row(qMin(y + radius + 1, last));
+        const quint32 *removed = row(qMax(y - radius, 0));
+        for (int x = 0; x < width; ++x)
+        {
+            out[x] = averageSum(&sums[4 * x], scale);
+            slideSum(&sums[4 * x], added[x], removed[x]);
+        }
+    }
+}
+
+void blurImage(QImage &image, int radius)
+{
+    if (radius <= 0 || image.isNull())
+        return;
+
+    Q_ASSERT(image.format() == QImage::Format_ARGB32_Premultiplied);
+    QImage temp(image.size(), image.format());
+    for (int pass = 0; pass < kBlurPasses; ++pass)
+    {
+        blurHorizontal(image, temp, radius);
+        blurVertical(temp, image, radius);
+    }
+}
+
+BackdropBlur::BackdropBlur() : m_radius(16), m_columns(0), m_rows(0) {}
+
+bool BackdropBlur::isNull() const
+{
+    return m_source.isNull();
+}
+
+void BackdropBlur::clear()
+{
+    m_source = QImage();
+    m_blurred = QImage();
+    resetTiles();
+}
+
+void BackdropBlur::releaseCache()
+{
+    m_blurred = QImage();
+    m_validTiles.fill(false);
+}
+
+void BackdropBlur::setSource(const QImage &image)
+{
+    m_source = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    m_blurred = QImage();
+    resetTiles();
+}
+
+void BackdropBlur::updateSource(const QImage &image, const QRect &dirtyRect)
+{
+    if (image.size() != m_source.size())
+    {
+        setSource(image);
+        return;
+    }
+
+    m_source = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    invalidate(dirtyRect);
+}
+
+const QImage &BackdropBlur::source() const
+{
+    return m_source;
+}
+
+void BackdropBlur::setRadius(int radius)
+{
+    radius = qMax(0, radius);
+    if (m_radius == radius)
+        return;
+
+    m_radius = radius;
+    m_validTiles.fill(false);
+}
+
+int BackdropBlur::radius() const
+{
+    return m_radius;
+}
+
+void BackdropBlur::invalidate(const QRect &rect)
+{
+    // A changed pixel affects every output pixel within the blur extent.
+    const int pad = kBlurPasses * m_radius;
+    const QRect area =
+        rect.adjusted(-pad, -pad, pad, pad) & m_source.rect();
+    if (area.isEmpty())
+        return;
+
+    for (int row = area.top() / kTileSize; row <= area.bottom() / kTileSize;
+         ++row)
+    {
+        for (int column = area.left() / kTileSize;
+             column <= area.right() / kTileSize; ++column)
+            m_validTiles.clearBit(tileIndex(column, row));
+    }
+}
+
+const QImage &BackdropBlur::blurred(const QRect &rect)
+{
+    const QRect area = rect & m_source.rect();
+    if (area.isEmpty())
+        return m_blurred;
+
+    if (m_blurred.isNull())
+        m_blurred = QImage(m_source.size(), m_source.format());
+
+    // Blur all missing tiles in one go so their padding is shared.
+    QRect missing;
+    for (int row = area.top() / kTileSize; row <= area.bottom() / kTileSize;
+         ++row)
+    {
+        for (int column = area.left() / kTileSize;
+             column <= area.right() / kTileSize; ++column)
+        {
+            if (!m_validTiles.testBit(tileIndex(column, row)))
+                missing |= tileRect(column, row);
+        }
+    }
+    if (missing.isEmpty())
+        return m_blurred;
+
+    const int pad = kBlurPasses * m_radius;
+    const QRect workRect =
+        missing.adjusted(-pad, -pad, pad, pad) & m_source.rect();
+    QImage work = m_source.copy(workRect);
+    blurImage(work, m_radius);
+
+    for (int row = missing.top() / kTileSize;
+         row <= missing.bottom() / kTileSize; ++row)
+    {
+        for (int column = missing.left() / kTileSize;
+             column <= missing.right() / kTileSize; ++column)
+        {
+            const int index = tileIndex(column, row);
+            if (m_validTiles.testBit(index))
+                continue;
+
+            const QRect tile = tileRect(column, row);
+            const QPoint offset = tile.topLeft() - workRect.topLeft();
+            for (int y = 0; y < tile.height(); ++y)
+            {
+                std::memcpy(
+                    m_blurred.scanLine(tile.y() + y) + 4 * tile.x(),
+                    work.constScanLine(offset.y() + y) + 4 * offset.x(),
+                    4 * tile.width());
+            }
+            m_validTiles.setBit(index);
+        }
+    }
+
+    return m_blurred;
+}
+
+qint64 BackdropBlur::cachedBytes() const
+{
+    return m_blurred.sizeInBytes();
+}
+
+int BackdropBlur::tileIndex(int column, int row) const
+{
+    return row * m_columns + column;
+}
+
+QRect BackdropBlur::tileRect(int column, int row) const
+{
+    return QRect(column * kTileSize, row * kTileSize, kTileSize, kTileSize) &
+           m_source.rect();
+}
+
+void BackdropBlur::resetTiles()
+{
+    m_columns = (m_source.width() + kTileSize - 1) / kTileSize;
+    m_rows = (m_source.height() + kTileSize - 1) / kTileSize;
+    m_validTiles = QBitArray(m_columns * m_rows, false);
+}
@@ -0,0 +1,53 @@
+#ifndef BACKDROPBLUR_H
+#define BACKDROPBLUR_H
+
+#include <QBitArray>
+#include <QImage>
+#include <QRect>
+
+// Blurs |image| in place with three separable box passes, which is close to
+// a gaussian of the same radius. |image| must be ARGB32_Premultiplied.
+void blurImage(QImage &image, int radius);
+
+// Caches the blurred version of a backdrop image. The blur is computed per
+// tile and only on demand, so moving a window over the backdrop or changing
+// part of the source only re-blurs the tiles that are actually needed.
+class BackdropBlur
+{
+public:
+    BackdropBlur();
+
+    bool isNull() const;
+    void clear();
+    // Drops the blurred tiles but keeps the source.
+    void releaseCache();
+
+    void setSource(const QImage &image);
+    void updateSource(const QImage &image, const QRect &dirtyRect);
+    const QImage &source() const;
+
+    void setRadius(int radius);
+    int radius() const;
+
+    void invalidate(const QRect &rect);
+
+    // Returns the blurred image, only |rect| is guaranteed to be up to date.
+    const QImage &blurred(const QRect &rect);
+
+    qint64 cachedBytes() const;
+
+private:
+    int tileIndex(int column, int row) const;
+    QRect tileRect(int column, int row) const;
+    void resetTiles();
+
+private:
+    QImage m_source;
+    QImage m_blurred;
+    QBitArray m_validTiles;
+    int m_radius;
+    int m_columns;
+    int m_rows;
+};
+
+#endif  // BACKDROPBLUR_H
@@ -0,0 +1,58 @@
+#include "chromecounters.h"
+
+#include <QCoreApplication>
+#include <QEvent>
+#include <QWidget>
+
+bool ChromeCounters::s_enabled = false;
+qint64 ChromeCounters::s_counts[ChromeCounters::kCounterCount] = {};
+
+class ChromeEventCounter : public QObject
+{
+protected:
+    virtual bool eventFilter(QObject *obj, QEvent *event) override
+    {
+        switch (event->type())
+        {
+            case QEvent::Paint:
+                if (obj->isWidgetType())
+                    ChromeCounters::add(ChromeCounters::kPaint);
+                break;
+            case QEvent::LayoutRequest:
+                if (obj->isWidgetType())
+                    ChromeCounters::add(ChromeCounters::kLayout);
+                break;
+            default:
+                break;
+        }
+        return QObject::eventFilter(obj, event);
+    }
+};
+
+static ChromeEventCounter *s_eventCounter = nullptr;
+
+void ChromeCounters::setEnabled(bool enable)
+{
+    s_enabled = enable;
+    if (enable && !s_eventCounter)
+    {
+        s_eventCounter = new ChromeEventCounter;
+        QCoreApplication::instance()->installEventFilter(s_eventCounter);
+    }
+    else if (!enable && s_eventCounter)
+    {
+        delete s_eventCounter;
+        s_eventCounter = nullptr;
+    }
+}
+
+qint64 ChromeCounters::count(Counter counter)
+{
+    return s_counts[counter];
+}
+
+void ChromeCounters::reset()
+{
+    for (int i = 0; i < kCounterCount; ++i)
+        s_counts[i] = 0;
+}
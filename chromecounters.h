@@ -0,0 +1,39 @@
+#ifndef CHROMECOUNTERS_H
+#define CHROMECOUNTERS_H
+
+#include <QtGlobal>
+
+// Counts work done by the window chrome for the diagnostic runs. Counting
+// is off by default and then only costs a branch.
+class ChromeCounters
+{
+public:
+    enum Counter
+    {
+        kPaint = 0,
+        kLayout,
+        kHitTest,
+        kResize,
+        kFrameRecalc,
+        kCounterCount
+    };
+
+    // Also installs an application event filter counting paints and layout
+    // requests of all widgets.
+    static void setEnabled(bool enable);
+    static bool isEnabled() { return s_enabled; }
+
+    static void add(Counter counter)
+    {
+        if (s_enabled)
+            ++s_counts[counter];
+    }
+    static qint64 count(Counter counter);
+    static void reset();
+
+private:
+    static bool s_enabled;
+    static qint64 s_counts[kCounterCount];
+};
+
+#endif  // CHROMECOUNTERS_H
@@ -0,0 +1,768 @@
+#include "chromediagnostics.h"
+
+#include <algorithm>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QGuiApplication>
+#include <QIcon>
+#include <QImage>
+#include <QMap>
+#include <QPainter>
+#include <QPair>
+#include <QRandomGenerator>
+#include <QScreen>
+#include <QSet>
+#include <QSettings>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QVector>
+#include <QWindow>
+#include <QtMath>
+
+#include "allocationcounter.h"
+#include "backdropblur.h"
+#include "chromecounters.h"
+#include "framelesshelper.h"
+#include "framelesswidget.h"
+#include "framelesswindow.h"
+#include "inputtrace.h"
+#include "sessionstate.h"
+#include "titlebarglyphs.h"
+
+FramelessWidget *createWindow(int index)
+{
+    FramelessWidget *window = new FramelessWidget;
+    window->setWindowTitle(QString("Frameless Window %1").arg(index));
+    window->setStyleSheet("background:white");
+    return window;
+}
+
+constexpr int kFirstPaintTimeout = 5000;
+
+// Flags the first paint event a widget receives and times it from the
+// first expose of its native window. Install it on both.
+class PaintWatcher : public QObject
+{
+public:
+    bool painted = false;
+    qint64 exposeToPaint = 0;
+
+protected:
+    virtual bool eventFilter(QObject *obj, QEvent *event) override
+    {
+        if (event->type() == QEvent::Expose && !m_exposed.isValid())
+        {
+            m_exposed.start();
+        }
+        else if (event->type() == QEvent::Paint && !painted)
+        {
+            painted = true;
+            if (m_exposed.isValid())
+                exposeToPaint = m_exposed.nsecsElapsed();
+        }
+        return QObject::eventFilter(obj, event);
+    }
+
+private:
+    QElapsedTimer m_exposed;
+};
+
+// Counts the widgets that got their first paint.
+class FirstPaintCounter : public QObject
+{
+public:
+    QSet<QObject *> painted;
+
+protected:
+    virtual bool eventFilter(QObject *obj, QEvent *event) override
+    {
+        if (event->type() == QEvent::Paint)
+            painted.insert(obj);
+        return QObject::eventFilter(obj, event);
+    }
+};
+
+qint64 percentile(const QVector<qint64> &sorted, int percent)
+{
+    if (sorted.isEmpty())
+        return 0;
+
+    const int index = (sorted.size() - 1) * percent / 100;
+    return sorted.at(index);
+}
+
+void printPhase(QTextStream &out, const char *name, QVector<qint64> &nsecs)
+{
+    std::sort(nsecs.begin(), nsecs.end());
+    out << qSetFieldWidth(14) << Qt::left << name << qSetFieldWidth(10)
+        << Qt::right << percentile(nsecs, 50) / 1000
+        << percentile(nsecs, 90) / 1000 << percentile(nsecs, 99) / 1000
+        << nsecs.last() / 1000 << qSetFieldWidth(0) << Qt::left << "\n";
+}
+
+void processAllEvents()
+{
+    QCoreApplication::processEvents();
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+    QCoreApplication::processEvents();
+}
+
+int runMemoryBudgetCheck(int count, qint64 budgetBytes)
+{
+    QTextStream out(stdout);
+    if (!isAllocationCountingEnabled())
+    {
+        out << "heap accounting is not available, "
+               "rebuild with CONFIG+=alloc_counter on glibc\n";
+        return 2;
+    }
+    count = qMax(1, count);
+
+    // Warm up shared state (fonts, style, resources) outside the budget.
+    delete createWindow(0);
+    processAllEvents();
+
+    const AllocationStats before = allocationStats();
+    QVector<FramelessWidget *> windows;
+    windows.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        FramelessWidget *window = createWindow(i);
+        window->show();
+        windows.append(window);
+    }
+    processAllEvents();
+    const AllocationStats shown = allocationStats();
+
+    qint64 chromeBytes = 0;
+    qint64 backingStoreBytes = 0;
+    for (auto window : windows)
+    {
+        const ChromeMemoryUsage usage = window->memoryUsage();
+        chromeBytes += usage.releasable();
+        backingStoreBytes += usage.backingStore;
+    }
+
+    // Measured rather than estimated, the parsed svgs have no known size.
+    const AllocationStats unreleased = allocationStats();
+    for (auto window : windows)
+        window->releaseResources();
+    const AllocationStats released = allocationStats();
+
+    qDeleteAll(windows);
+    windows.clear();
+    processAllEvents();
+    const AllocationStats destroyed = allocationStats();
+
+    const qint64 bytesPerWindow = (shown.liveBytes - before.liveBytes) / count;
+    const qint64 allocationsPerWindow =
+        (shown.allocations - before.allocations) / count;
+    out << "windows:                 " << count << "\n"
+        << "heap bytes per window:   " << bytesPerWindow << "\n"
+        << "allocations per window:  " << allocationsPerWindow
+        << " (reallocs count when they grow)\n"
+        << "chrome bytes per window: " << chromeBytes / count << "\n"
+        << "heap freed by release:   "
+        << (unreleased.liveBytes - released.liveBytes) / count
+        << " per window\n"
+        << "backing store estimate:  " << backingStoreBytes / count
+        << " (reported only, never released)\n"
+        << "bytes left after delete: "
+        << destroyed.liveBytes - before.liveBytes << "\n";
+
+    if (budgetBytes > 0 && bytesPerWindow > budgetBytes)
+    {
+        out << "FAIL: budget of " << budgetBytes << " bytes per window "
+            << "exceeded\n";
+        return 1;
+    }
+    return 0;
+}
+
+int runLifecycleBenchmark(int runs)
+{
+    QTextStream out(stdout);
+    runs = qMax(1, runs);
+    const QIcon icon(":/logo/logo.png");
+
+    QVector<qint64> construction, nativeHandle, firstPaint, destruction;
+    construction.reserve(runs);
+    nativeHandle.reserve(runs);
+    firstPaint.reserve(runs);
+    destruction.reserve(runs);
+
+    QElapsedTimer timer;
+    for (int i = 0; i < runs; ++i)
+    {
+        timer.start();
+        FramelessWidget *window = createWindow(i);
+        window->setWindowIcon(icon);
+        construction.append(timer.nsecsElapsed());
+
+        timer.start();
+        window->winId();
+        nativeHandle.append(timer.nsecsElapsed());
+
+        // show() and mapping the window aren't part of the phase
+        PaintWatcher watcher;
+        window->installEventFilter(&watcher);
+        window->windowHandle()->installEventFilter(&watcher);
+        timer.start();
+        window->show();
+        while (!watcher.painted && timer.elapsed() < kFirstPaintTimeout)
+            QCoreApplication::processEvents();
+        firstPaint.append(watcher.exposeToPaint);
+        window->removeEventFilter(&watcher);
+        window->windowHandle()->removeEventFilter(&watcher);
+        if (!watcher.painted)
+        {
+            out << "run " << i << ": no paint within " << kFirstPaintTimeout
+                << " ms\n";
+        }
+
+        timer.start();
+        delete window;
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+        destruction.append(timer.nsecsElapsed());
+    }
+
+    out << "platform: " << QGuiApplication::platformName() << ", runs: " << runs
+        << ", times in us\n";
+    out << qSetFieldWidth(14) << Qt::left << "phase" << qSetFieldWidth(10)
+        << Qt::right << "p50" << "p90" << "p99" << "max" << qSetFieldWidth(0)
+        << Qt::left << "\n";
+    printPhase(out, "construction", construction);
+    printPhase(out, "native handle", nativeHandle);
+    printPhase(out, "first paint", firstPaint);
+    printPhase(out, "destruction", destruction);
+    return 0;
+}
+
+// Size at |step| of a scripted live resize, growing and shrinking again.
+QSize liveResizeSize(int step)
+{
+    const int t = step % 200;
+    const int d = t < 100 ? t : 200 - t;
+    return QSize(600 + d * 8, 400 + d * 5);
+}
+
+// Resizes |window| through |steps| sizes, returns the time of each step
+// including the repaint and adds the heap allocations to |allocations|.
+template <typename Window>
+QVector<qint64> scriptResize(Window *window, int steps, qint64 &allocations)
+{
+    QVector<qint64> nsecs;
+    nsecs.reserve(steps);
+    QElapsedTimer timer;
+    const AllocationStats before = allocationStats();
+    for (int i = 0; i < steps; ++i)
+    {
+        timer.start();
+        window->resize(liveResizeSize(i));
+        processAllEvents();
+        nsecs.append(timer.nsecsElapsed());
+    }
+    allocations = allocationStats().allocations - before.allocations;
+    return nsecs;
+}
+
+int runResizeBenchmark(int steps)
+{
+    QTextStream out(stdout);
+    steps = qMax(1, steps);
+
+    FramelessWindow *window = new FramelessWindow;
+    window->setTitle("Frameless Window");
+    window->show();
+    processAllEvents();
+    qint64 windowAllocations = 0;
+    const int storeAllocations = window->backingStoreAllocations();
+    QVector<qint64> windowFrames =
+        scriptResize(window, steps, windowAllocations);
+    const int storeReallocations =
+        window->backingStoreAllocations() - storeAllocations;
+    delete window;
+
+    FramelessWidget *widget = createWindow(0);
+    widget->show();
+    processAllEvents();
+    qint64 widgetAllocations = 0;
+    QVector<qint64> widgetFrames =
+        scriptResize(widget, steps, widgetAllocations);
+    delete widget;
+    processAllEvents();
+
+    out << "platform: " << QGuiApplication::platformName()
+        << ", resizes: " << steps << ", times in us\n";
+    out << qSetFieldWidth(14) << Qt::left << "phase" << qSetFieldWidth(10)
+        << Qt::right << "p50" << "p90" << "p99" << "max" << qSetFieldWidth(0)
+        << Qt::left << "\n";
+    printPhase(out, "QWindow", windowFrames);
+    printPhase(out, "QWidget", widgetFrames);
+    out << "QWindow backing store reallocations: " << storeReallocations
+        << "\n";
+    if (isAllocationCountingEnabled())
+    {
+        out << "heap allocations per resize, QWindow: "
+            << windowAllocations / steps
+            << ", QWidget: " << widgetAllocations / steps << "\n";
+    }
+    else
+    {
+        out << "heap allocations are not counted, "
+               "rebuild with CONFIG+=alloc_counter on glibc\n";
+    }
+    return 0;
+}
+
+int runBlurBenchmark(int frames)
+{
+    QTextStream out(stdout);
+    frames = qMax(1, frames);
+
+    // Noise, so no part of the desktop blurs faster than another.
+    QImage source(3840, 2160, QImage::Format_ARGB32_Premultiplied);
+    QRandomGenerator random(1);
+    for (int y = 0; y < source.height(); ++y)
+    {
+        quint32 *line = reinterpret_cast<quint32 *>(source.scanLine(y));
+        for (int x = 0; x < source.width(); ++x)
+            line[x] = random.generate() | 0xff000000;
+    }
+
+    BackdropBlur backdrop;
+    backdrop.setSource(source);
+    const QRect window(0, 0, 1280, 800);
+
+    QVector<qint64> fullFrame, windowMove, sourceUpdate;
+    fullFrame.reserve(frames);
+    windowMove.reserve(frames);
+    sourceUpdate.reserve(frames);
+
+    QElapsedTimer timer;
+    for (int i = 0; i < frames; ++i)
+    {
+        QImage frame = source.copy();
+        timer.start();
+        blurImage(frame, backdrop.radius());
+        fullFrame.append(timer.nsecsElapsed());
+
+        // dragged by 16 by 8 pixels per frame
+        const QRect rect = window.translated(
+            i * 16 % (source.width() - window.width()),
+            i * 8 % (source.height() - window.height()));
+        timer.start();
+        backdrop.blurred(rect);
+        windowMove.append(timer.nsecsElapsed());
+
+        timer.start();
+        backdrop.invalidate(QRect(rect.center(), QSize(256, 256)));
+        backdrop.blurred(rect);
+        sourceUpdate.append(timer.nsecsElapsed());
+    }
+
+    out << "source: " << source.width() << "x" << source.height()
+        << ", radius: " << backdrop.radius() << ", frames: " << frames
+        << ", times in us\n";
+    out << qSetFieldWidth(14) << Qt::left << "phase" << qSetFieldWidth(10)
+        << Qt::right << "p50" << "p90" << "p99" << "max" << qSetFieldWidth(0)
+        << Qt::left << "\n";
+    printPhase(out, "full frame", fullFrame);
+    printPhase(out, "window move", windowMove);
+    printPhase(out, "source update", sourceUpdate);
+    return 0;
+}
+
+int runInputReplay(const QString &fileName, double maxPaintsPerEvent)
+{
+    QTextStream out(stdout);
+    InputTraceReplayer replayer;
+    if (!replayer.load(fileName))
+    {
+        out << "can't read input trace " << fileName << "\n";
+        return 2;
+    }
+
+    FramelessWidget *window = createWindow(0);
+    window->show();
+    processAllEvents();
+
+    ChromeCounters::reset();
+    ChromeCounters::setEnabled(true);
+    QVector<qint64> nsecs = replayer.replay(window);
+    ChromeCounters::setEnabled(false);
+
+    qint64 total = 0;
+    for (auto value : nsecs)
+        total += value;
+    const qint64 paints = ChromeCounters::count(ChromeCounters::kPaint);
+    const double paintsPerEvent =
+        nsecs.isEmpty() ? 0.0 : double(paints) / nsecs.size();
+
+    out << "platform: " << QGuiApplication::platformName()
+        << ", events: " << nsecs.size() << "\n"
+        << "paints:     " << paints << " (" << paintsPerEvent
+        << " per event)\n"
+        << "layouts:    " << ChromeCounters::count(ChromeCounters::kLayout)
+        << "\n"
+        << "hit tests:  " << ChromeCounters::count(ChromeCounters::kHitTest)
+        << "\n"
+        << "total:      " << total / 1000 << " us\n";
+    if (!nsecs.isEmpty())
+    {
+        out << qSetFieldWidth(14) << Qt::left << "phase" << qSetFieldWidth(10)
+            << Qt::right << "p50" << "p90" << "p99" << "max"
+            << qSetFieldWidth(0) << Qt::left << "\n";
+        printPhase(out, "event", nsecs);
+    }
+
+    delete window;
+    if (maxPaintsPerEvent >= 0 && paintsPerEvent > maxPaintsPerEvent)
+    {
+        out << "FAIL: more than " << maxPaintsPerEvent
+            << " paints per event\n";
+        return 1;
+    }
+    return 0;
+}
+
+struct TransitionStats
+{
+    int count = 0;
+    int redundant = 0;
+    qint64 work[ChromeCounters::kCounterCount] = {};
+};
+
+int runStateStress(int transitions, quint32 seed, double maxRedundantPercent)
+{
+    QTextStream out(stdout);
+    const Qt::WindowState states[] = {
+        Qt::WindowNoState, Qt::WindowMinimized, Qt::WindowMaximized,
+        Qt::WindowFullScreen};
+    const char *stateNames[] = {"normal", "minimized", "maximized",
+                                "fullscreen"};
+    const int stateCount = 4;
+    const ChromeCounters::Counter workCounters[] = {
+        ChromeCounters::kPaint, ChromeCounters::kLayout,
+        ChromeCounters::kResize, ChromeCounters::kFrameRecalc};
+    const char *workNames[] = {"paints", "layouts", "resizes", "frames"};
+    const int workCount = 4;
+
+    FramelessWidget *window = createWindow(0);
+    window->show();
+    processAllEvents();
+
+    QRandomGenerator random(seed);
+    QMap<QPair<int, int>, TransitionStats> stats;
+    QImage pixels = window->grab().toImage();
+    int state = 0;
+    int redundant = 0;
+
+    ChromeCounters::setEnabled(true);
+    for (int i = 0; i < transitions; ++i)
+    {
+        const int target = random.bounded(stateCount);
+        ChromeCounters::reset();
+        window->setWindowState(states[target]);
+        processAllEvents();
+
+        // Read the counters before grabbing, grab() paints too.
+        TransitionStats &transition = stats[qMakePair(state, target)];
+        ++transition.count;
+        qint64 work = 0;
+        for (int c = 0; c < workCount; ++c)
+        {
+            const qint64 value = ChromeCounters::count(workCounters[c]);
+            transition.work[workCounters[c]] += value;
+            work += value;
+        }
+
+        const QImage newPixels = window->grab().toImage();
+        if (work > 0 && newPixels == pixels)
+        {
+            ++transition.redundant;
+            ++redundant;
+        }
+        pixels = newPixels;
+        state = target;
+    }
+    ChromeCounters::setEnabled(false);
+    delete window;
+
+    out << "transitions: " << transitions << ", seed: " << seed
+        << ", average work per transition\n";
+    out << qSetFieldWidth(24) << Qt::left << "transition"
+        << qSetFieldWidth(10) << Qt::right << "count";
+    for (int c = 0; c < workCount; ++c)
+        out << workNames[c];
+    out << "redundant" << qSetFieldWidth(0) << Qt::left << "\n";
+
+    for (auto it = stats.constBegin(); it != stats.constEnd(); ++it)
+    {
+        const TransitionStats &transition = it.value();
+        const QString name = QString("%1 -> %2")
+                                 .arg(stateNames[it.key().first])
+                                 .arg(stateNames[it.key().second]);
+        out << qSetFieldWidth(24) << Qt::left << name << qSetFieldWidth(10)
+            << Qt::right << transition.count;
+        for (int c = 0; c < workCount; ++c)
+        {
+            out << QString::number(
+                double(transition.work[workCounters[c]]) / transition.count,
+                'f', 1);
+        }
+        out << transition.redundant << qSetFieldWidth(0) << Qt::left
+            << "\n";
+    }
+
+    const double redundantPercent =
+        transitions > 0 ? 100.0 * redundant / transitions : 0.0;
+    out << "redundant transitions: " << redundant << " ("
+        << QString::number(redundantPercent, 'f', 1) << "%)\n";
+    if (maxRedundantPercent >= 0 && redundantPercent > maxRedundantPercent)
+    {
+        out << "FAIL: more than " << maxRedundantPercent
+            << "% redundant transitions\n";
+        return 1;
+    }
+    return 0;
+}
+
+int runRestoreBenchmark(int count)
+{
+    QTextStream out(stdout);
+    count = qMax(1, count);
+    QTemporaryDir dir;
+    if (!dir.isValid())
+    {
+        out << "can't create a temporary directory\n";
+        return 2;
+    }
+
+    const QString screenName =
+        QGuiApplication::primaryScreen()
+            ? QGuiApplication::primaryScreen()->name()
+            : QString();
+    QVector<SessionWindowState> states;
+    states.reserve(count);
+    for (int i = 0; i < count; ++i)
+    {
+        SessionWindowState state;
+        state.geometry = QRect(40 + i % 20 * 24, 40 + i % 20 * 24, 500, 400);
+        state.states = i % 10 == 0 ? Qt::WindowMaximized : Qt::WindowNoState;
+        state.screenName = screenName;
+        state.title = QString("Frameless Window %1").arg(i);
+        states.append(state);
+    }
+
+    QElapsedTimer timer;
+    const QString fileName = dir.filePath("session.bin");
+    timer.start();
+    {
+        SessionStateFile file;
+        if (!file.write(fileName, states))
+        {
+            out << "can't write " << fileName << "\n";
+            return 2;
+        }
+    }
+    const qint64 sessionWrite = timer.nsecsElapsed();
+
+    // the per window QSettings layout this replaces
+    timer.start();
+    {
+        QSettings settings(dir.filePath("session.ini"), QSettings::IniFormat);
+        for (int i = 0; i < count; ++i)
+        {
+            settings.beginGroup(QString("window%1").arg(i));
+            settings.setValue("geometry", states.at(i).geometry);
+            settings.setValue("state", int(states.at(i).states));
+            settings.setValue("screen", states.at(i).screenName);
+            settings.setValue("title", states.at(i).title);
+            settings.endGroup();
+        }
+    }
+    const qint64 settingsWrite = timer.nsecsElapsed();
+
+    timer.start();
+    {
+        QSettings settings(dir.filePath("session.ini"), QSettings::IniFormat);
+        for (int i = 0; i < count; ++i)
+        {
+            settings.beginGroup(QString("window%1").arg(i));
+            SessionWindowState state;
+            state.geometry = settings.value("geometry").toRect();
+            state.states =
+                Qt::WindowStates(QFlag(settings.value("state").toInt()));
+            state.screenName = settings.value("screen").toString();
+            state.title = settings.value("title").toString();
+            settings.endGroup();
+        }
+    }
+    const qint64 settingsRead = timer.nsecsElapsed();
+
+    // Warm up shared state (fonts, style, resources) outside the timings.
+    delete createWindow(0);
+    processAllEvents();
+
+    SessionStateFile file;
+    timer.start();
+    if (!file.open(fileName))
+    {
+        out << "can't open " << fileName << "\n";
+        return 2;
+    }
+    for (int i = 0; i < file.count(); ++i)
+        file.state(i);
+    const qint64 sessionRead = timer.nsecsElapsed();
+
+    FirstPaintCounter paints;
+    QVector<FramelessWidget *> windows;
+    windows.reserve(file.count());
+    ChromeCounters::reset();
+    ChromeCounters::setEnabled(true);
+    timer.start();
+    for (int i = 0; i < file.count(); ++i)
+    {
+        FramelessWidget *window = new FramelessWidget;
+        window->setStyleSheet("background:white");
+        applySessionWindowState(window, file.state(i));
+        window->installEventFilter(&paints);
+        window->show();
+        windows.append(window);
+    }
+    const qint64 restore = timer.nsecsElapsed();
+    // first paint on its own, without the restore above
+    timer.start();
+    while (paints.painted.size() < windows.size() &&
+           timer.elapsed() < kFirstPaintTimeout)
+        QCoreApplication::processEvents();
+    const qint64 firstPaint = timer.nsecsElapsed();
+    ChromeCounters::setEnabled(false);
+    for (auto window : windows)
+        window->removeEventFilter(&paints);
+
+    // incremental saves through the tracker, one record each
+    SessionTracker tracker(&file);
+    for (int i = 0; i < windows.size(); ++i)
+        tracker.track(windows.at(i), i);
+    for (auto window : windows)
+        window->move(window->pos() + QPoint(1, 1));
+    processAllEvents();
+    timer.start();
+    tracker.flush();
+    const qint64 update = timer.nsecsElapsed();
+    int saved = 0;
+    for (int i = 0; i < windows.size(); ++i)
+    {
+        const QRect geometry = sessionWindowState(windows.at(i)).geometry;
+        if (file.state(i).geometry == geometry)
+            ++saved;
+    }
+
+    out << "platform: " << QGuiApplication::platformName()
+        << ", windows: " << windows.size() << ", times in us\n"
+        << "session write:  " << sessionWrite / 1000 << "\n"
+        << "settings write: " << settingsWrite / 1000 << "\n"
+        << "session read:   " << sessionRead / 1000 << "\n"
+        << "settings read:  " << settingsRead / 1000 << "\n"
+        << "restore + show: " << restore / 1000 << "\n"
+        << "first paint:    " << firstPaint / 1000 << " ("
+        << paints.painted.size() << " painted)\n"
+        << "record update:  " << update / 1000 / qMax(1, windows.size())
+        << " per window, " << saved << " saved\n"
+        << "resizes:        "
+        << ChromeCounters::count(ChromeCounters::kResize) << "\n"
+        << "layouts:        "
+        << ChromeCounters::count(ChromeCounters::kLayout) << "\n";
+
+    qDeleteAll(windows);
+    processAllEvents();
+    return 0;
+}
+
+QImage renderGlyph(TitleBarGlyph glyph, qreal dpr)
+{
+    QImage image(
+        qCeil(kTitleBarButtonWidth * dpr), qCeil(kTitleBarHeight * dpr),
+        QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    QPainter painter(&image);
+    // like a widget painter on a high DPI screen
+    painter.scale(dpr, dpr);
+    drawTitleBarGlyph(&painter, glyph, Qt::black, dpr);
+    return image;
+}
+
+int countDifferentPixels(const QImage &a, const QImage &b)
+{
+    if (a.size() != b.size())
+        return a.width() * a.height();
+
+    int count = 0;
+    for (int y = 0; y < a.height(); ++y)
+    {
+        const QRgb *lineA = reinterpret_cast<const QRgb *>(a.scanLine(y));
+        const QRgb *lineB = reinterpret_cast<const QRgb *>(b.scanLine(y));
+        for (int x = 0; x < a.width(); ++x)
+        {
+            if (lineA[x] != lineB[x])
+                ++count;
+        }
+    }
+    return count;
+}
+
+int runGlyphCheck()
+{
+    QTextStream out(stdout);
+    // the compile time tables and one scale computed at run time
+    const int percents[] = {100, 125, 150, 175, 200};
+    const char *glyphNames[] = {"minimize", "maximize", "restore"};
+    const int glyphCount = static_cast<int>(TitleBarGlyph::kGlyphCount);
+    int failures = 0;
+    for (int percent : percents)
+    {
+        const qreal dpr = percent / 100.0;
+        for (int i = 0; i < glyphCount; ++i)
+        {
+            const TitleBarGlyph glyph = static_cast<TitleBarGlyph>(i);
+            const QString fileName = QString(":/glyphs/res/glyphs/%1_%2.png")
+                                         .arg(glyphNames[i])
+                                         .arg(percent);
+            const QImage expected =
+                QImage(fileName).convertToFormat(
+                    QImage::Format_ARGB32_Premultiplied);
+            out << qSetFieldWidth(10) << Qt::left << glyphNames[i]
+                << qSetFieldWidth(6) << Qt::right << dpr << qSetFieldWidth(0)
+                << Qt::left << "  ";
+            if (expected.isNull())
+            {
+                ++failures;
+                out << "no reference " << fileName << "\n";
+                continue;
+            }
+
+            const int different =
+                countDifferentPixels(renderGlyph(glyph, dpr), expected);
+            if (different > 0)
+            {
+                ++failures;
+                out << different << " pixels differ\n";
+            }
+            else
+            {
+                out << "ok\n";
+            }
+        }
+    }
+
+    if (failures > 0)
+    {
+        out << "FAIL: " << failures << " glyphs\n";
+        return 1;
+    }
+    return 0;
+}
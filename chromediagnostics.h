@@ -0,0 +1,50 @@
+#ifndef CHROMEDIAGNOSTICS_H
+#define CHROMEDIAGNOSTICS_H
+
+#include <QString>
+
+// Diagnostic runs of the demo application, they print a report to stdout
+// and return the process exit code.
+
+// Heap a shown 500x500 FramelessWidget may cost. It leaves room for a
+// heap allocated backing store at scale 1, about 1 MiB, and the chrome.
+constexpr qint64 kDefaultWindowBudget = 2 * 1024 * 1024;
+
+// Creates, shows and destroys |count| FramelessWidgets and fails when one
+// window costs more than |budgetBytes| of heap. Needs CONFIG+=alloc_counter.
+int runMemoryBudgetCheck(int count, qint64 budgetBytes);
+
+// Times construction, native window creation, show to first paint and
+// destruction of a FramelessWidget over |runs| runs and prints percentiles.
+int runLifecycleBenchmark(int runs);
+
+// Resizes a FramelessWindow and a FramelessWidget through the same |steps|
+// sizes of a live resize and compares heap allocations, backing store
+// reallocations and frame times.
+int runResizeBenchmark(int steps);
+
+// Blurs a 3840x2160 backdrop for |frames| frames, in full, for a window
+// dragged across it and after part of it changed, and prints percentiles.
+int runBlurBenchmark(int frames);
+
+// Replays an input trace recorded with InputTraceRecorder on a fresh window
+// and prints paint, layout and hit test counts with per-event timings. Fails
+// when the events caused more than |maxPaintsPerEvent| paints on average,
+// a negative value disables the check.
+int runInputReplay(const QString &fileName, double maxPaintsPerEvent);
+
+// Drives |transitions| random window state changes, counts the work each
+// one causes and flags work that left the window pixels unchanged. Fails
+// when more than |maxRedundantPercent| of the transitions were redundant.
+int runStateStress(int transitions, quint32 seed, double maxRedundantPercent);
+
+// Restores |count| windows from a memory mapped session file and compares
+// saving and loading their state with QSettings.
+int runRestoreBenchmark(int count);
+
+// Renders the caption glyphs at the 100, 125, 150, 175 and 200 percent
+// scales and fails when a pixel differs from the reference images in
+// res/glyphs, which were rendered by the former drawing code.
+int runGlyphCheck();
+
+#endif  // CHROMEDIAGNOSTICS_H
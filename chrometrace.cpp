@@ -0,0 +1,169 @@
+#include "chrometrace.h"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifdef Q_OS_UNIX
+#include <signal.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <QCoreApplication>
+#include <QEvent>
+#include <QFile>
+#include <QSocketNotifier>
+#include <QTextStream>
+
+constexpr int kRingBufferSize = 1 << 16;
+
+struct TraceEvent
+{
+    const char *name;
+    qint64 start;
+    qint64 duration;
+};
+
+struct ThreadBuffer
+{
+    std::vector<TraceEvent> events;
+    quint64 next = 0;
+    int threadId = 0;
+};
+
+// Buffers stay registered after their thread exits so they can be dumped.
+static std::mutex s_buffersMutex;
+static std::vector<std::shared_ptr<ThreadBuffer>> s_buffers;
+
+std::atomic<bool> ChromeTrace::s_enabled(false);
+
+static ThreadBuffer *threadBuffer()
+{
+    thread_local std::shared_ptr<ThreadBuffer> buffer;
+    if (!buffer)
+    {
+        buffer = std::make_shared<ThreadBuffer>();
+        buffer->events.resize(kRingBufferSize);
+        std::lock_guard<std::mutex> lock(s_buffersMutex);
+        buffer->threadId = static_cast<int>(s_buffers.size()) + 1;
+        s_buffers.push_back(buffer);
+    }
+    return buffer.get();
+}
+
+void ChromeTrace::setEnabled(bool enable)
+{
+    s_enabled.store(enable, std::memory_order_relaxed);
+}
+
+qint64 ChromeTrace::now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void ChromeTrace::record(const char *name, qint64 start, qint64 duration)
+{
+    ThreadBuffer *buffer = threadBuffer();
+    TraceEvent &event = buffer->events[buffer->next % kRingBufferSize];
+    event.name = name;
+    event.start = start;
+    event.duration = duration;
+    ++buffer->next;
+}
+
+bool ChromeTrace::dump(const QString &fileName)
+{
+    QFile f(fileName);
+    if (!f.open(QFile::WriteOnly | QFile::Truncate))
+        return false;
+
+    QTextStream out(&f);
+    out.setRealNumberNotation(QTextStream::FixedNotation);
+    out.setRealNumberPrecision(3);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+
+    const qint64 pid = QCoreApplication::applicationPid();
+    bool first = true;
+    std::lock_guard<std::mutex> lock(s_buffersMutex);
+    for (const auto &buffer : s_buffers)
+    {
+        const quint64 end = buffer->next;
+        const quint64 size = kRingBufferSize;
+        const quint64 begin = end > size ? end - size : 0;
+        for (quint64 i = begin; i < end; ++i)
+        {
+            const TraceEvent &event = buffer->events[i % kRingBufferSize];
+            out << (first ? "\n" : ",\n") << "{\"name\":\"" << event.name
+                << "\",\"ph\":\"X\",\"ts\":" << event.start / 1000.0
+                << ",\"dur\":" << event.duration / 1000.0 << ",\"pid\":" << pid
+                << ",\"tid\":" << buffer->threadId << "}";
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+    out.flush();
+    return f.error() == QFile::NoError;
+}
+
+#ifdef Q_OS_UNIX
+static int s_signalFds[2] = {-1, -1};
+
+static void handleDumpSignal(int)
+{
+    char byte = 1;
+    ssize_t written = ::write(s_signalFds[0], &byte, sizeof(byte));
+    Q_UNUSED(written)
+}
+
+class DumpSignalNotifier : public QSocketNotifier
+{
+public:
+    DumpSignalNotifier(const QString &fileName, QObject *parent)
+        : QSocketNotifier(s_signalFds[1], QSocketNotifier::Read, parent),
+          m_fileName(fileName)
+    {
+    }
+
+protected:
+    virtual bool event(QEvent *event) override
+    {
+        if (event->type() != QEvent::SockAct)
+            return QSocketNotifier::event(event);
+
+        char byte;
+        ssize_t bytes = ::read(s_signalFds[1], &byte, sizeof(byte));
+        Q_UNUSED(bytes)
+        ChromeTrace::dump(m_fileName);
+        return true;
+    }
+
+private:
+    QString m_fileName;
+};
+#endif
+
+bool ChromeTrace::dumpOnSignal(const QString &fileName)
+{
+#ifdef Q_OS_UNIX
+    // The signal handler only wakes up the event loop, the dump itself runs
+    // on the GUI thread.
+    if (s_signalFds[0] != -1 ||
+        ::socketpair(AF_UNIX, SOCK_STREAM, 0, s_signalFds) != 0)
+        return false;
+
+    new DumpSignalNotifier(fileName, QCoreApplication::instance());
+
+    struct sigaction action = {};
+    action.sa_handler = handleDumpSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    return ::sigaction(SIGUSR1, &action, nullptr) == 0;
+#else
+    Q_UNUSED(fileName)
+    return false;
+#endif
+}
@@ -0,0 +1,60 @@
+#ifndef CHROMETRACE_H
+#define CHROMETRACE_H
+
+#include <atomic>
+
+#include <QString>
+
+// Scoped trace events of the window chrome. Every thread records into its
+// own ring buffer, dump() writes all of them as Chrome trace JSON which
+// chrome://tracing and Perfetto can open. While disabled a scope costs a
+// single branch.
+class ChromeTrace
+{
+public:
+    static bool isEnabled()
+    {
+        return s_enabled.load(std::memory_order_relaxed);
+    }
+    static void setEnabled(bool enable);
+
+    static qint64 now();
+    static void record(const char *name, qint64 start, qint64 duration);
+
+    static bool dump(const QString &fileName);
+    // Dumps to |fileName| whenever the process receives SIGUSR1, only
+    // supported on unix.
+    static bool dumpOnSignal(const QString &fileName);
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+class ChromeTraceScope
+{
+public:
+    explicit ChromeTraceScope(const char *name) : m_name(nullptr), m_start(0)
+    {
+        if (ChromeTrace::isEnabled())
+        {
+            m_name = name;
+            m_start = ChromeTrace::now();
+        }
+    }
+    ~ChromeTraceScope()
+    {
+        if (m_name)
+            ChromeTrace::record(m_name, m_start, ChromeTrace::now() - m_start);
+    }
+
+private:
+    const char *m_name;
+    qint64 m_start;
+};
+
+#define CHROME_TRACE_CONCAT_IMPL(a, b) a##b
+#define CHROME_TRACE_CONCAT(a, b) CHROME_TRACE_CONCAT_IMPL(a, b)
+#define CHROME_TRACE_SCOPE(name) \
+    ChromeTraceScope CHROME_TRACE_CONCAT(chromeTraceScope, __LINE__)(name)
+
+#endif  // CHROMETRACE_H
@@ -0,0 +1,461 @@
+#include "framelesshelper.h"
+
+#include <cmath>
+#include <vector>
+
+#ifdef Q_OS_WIN
+#include <Windows.h>
+#include <dwmapi.h>
+#include <windowsx.h>
+#include <wingdi.h>
+#endif
+
+#include <QGuiApplication>
+#include <QOperatingSystemVersion>
+#include <QScreen>
+#include <QWindow>
+
+#ifdef FRAMELESS_X11EXTRAS
+#include <QX11Info>
+#endif
+
+#include "chromecounters.h"
+
+#ifdef Q_OS_WIN
+constexpr int kTaskbarAutoHideThickness = 2;
+
+enum class TaskbarPostion
+{
+    kLeft = 0,
+    kTop = 1,
+    kRight = 2,
+    kBottom = 3,
+    kNoPos = 4
+};
+
+bool isFullScreenWin(HWND hWnd)
+{
+    RECT winRect;
+    ::GetWindowRect(hWnd, &winRect);
+
+    HMONITOR monitor = ::MonitorFromWindow(hWnd, MONITOR_DEFAULTTOPRIMARY);
+    MONITORINFO monitorInfo;
+    if (::GetMonitorInfo(monitor, &monitorInfo) == FALSE)
+        return false;
+
+    RECT monitorRect = monitorInfo.rcMonitor;
+
+    if (monitorRect.top == winRect.top &&
+        monitorRect.bottom == winRect.bottom &&
+        monitorRect.left == winRect.left && monitorRect.right == winRect.right)
+        return true;
+
+    return false;
+}
+
+QWindow *findWindow(HWND hWnd)
+{
+    if (!hWnd)
+        return nullptr;
+
+    QWindowList windows = QGuiApplication::topLevelWindows();
+
+    if (windows.count() == 0)
+        return 0;
+
+    for (auto window : windows)
+    {
+        if (window && reinterpret_cast<HWND>(window->winId()) == hWnd)
+            return window;
+    }
+}
+
+int getDpiForWindow(HWND hWnd, bool horizontal)
+{
+#if (WINVER >= 0x0605)
+    return ::GetDpiForWindow(hWnd);
+#endif
+    HDC hdc = ::GetDC(hWnd);
+    int dpiX = ::GetDeviceCaps(hdc, LOGPIXELSX);
+    int dpiY = ::GetDeviceCaps(hdc, LOGPIXELSY);
+    ReleaseDC(hWnd, hdc);
+    if (dpiX > 0 && horizontal)
+        return dpiX;
+    else if (dpiY > 0 && !horizontal)
+        return dpiY;
+
+    return 96;
+}
+
+int getSystemMetrics(HWND hWnd, int index, bool horizontal)
+{
+#if (WINVER >= 0x0605)
+    int dpi = getDpiForWindow(hWnd, horizontal);
+    return ::GetSystemMetricsForDpi(index, dpi);
+#endif
+    return ::GetSystemMetrics(index);
+}
+
+bool isCompositionEnabled()
+{
+    BOOL result = FALSE;
+    bool success = (::DwmIsCompositionEnabled(&result) == S_OK);
+    return (result == TRUE) && success;
+}
+
+int getResizeBorderThickness(HWND hWnd, bool horizontal)
+{
+    QWindow *window = findWindow(hWnd);
+    if (!window)
+        return 0;
+
+    int frame = SM_CYSIZEFRAME;
+    if (horizontal)
+        frame = SM_CXSIZEFRAME;
+
+    int result = getSystemMetrics(hWnd, frame, horizontal) +
+                 getSystemMetrics(hWnd, 92, horizontal);
+
+    if (result > 0)
+        return result;
+
+    int thickness = 8;
+    if (!isCompositionEnabled())
+        thickness = 4;
+
+    return std::round(thickness * window->devicePixelRatio());
+}
+
+void addWindowAnimation(HWND hWnd)
+{
+    LONG style = ::GetWindowLong(hWnd, GWL_STYLE);
+    ::SetWindowLong(
+        hWnd, GWL_STYLE,
+        style | WS_MINIMIZEBOX | WS_MAXIMIZEBOX | WS_CAPTION | CS_DBLCLKS |
+            WS_THICKFRAME);
+}
+
+void addShadowEffect(HWND hWnd)
+{
+    if (!isCompositionEnabled())
+        return;
+
+    MARGINS margins;
+    margins.cxLeftWidth = -1;
+    margins.cyTopHeight = -1;
+    margins.cxRightWidth = -1;
+    margins.cyBottomHeight = -1;
+    ::DwmExtendFrameIntoClientArea(hWnd, &margins);
+}
+
+bool isTaskbarAutoHide()
+{
+    APPBARDATA appbarData;
+    memset(&appbarData, 0, sizeof(APPBARDATA));
+    appbarData.cbSize = sizeof(APPBARDATA);
+    UINT_PTR taskbarState = ::SHAppBarMessage(ABM_GETSTATE, &appbarData);
+    return (taskbarState == ABS_AUTOHIDE);
+}
+
+bool isGreaterEqualWin8_1()
+{
+    return QOperatingSystemVersion::current() >=
+           QOperatingSystemVersion::Windows8_1;
+}
+
+bool isGreaterWin7()
+{
+    return QOperatingSystemVersion::current() >
+           QOperatingSystemVersion::Windows7;
+}
+
+TaskbarPostion getTaskbarPosition(HWND hWnd)
+{
+    APPBARDATA appbarData;
+    memset(&appbarData, 0, sizeof(APPBARDATA));
+    appbarData.cbSize = sizeof(APPBARDATA);
+    if (isGreaterEqualWin8_1())
+    {
+        HMONITOR monitor = ::MonitorFromWindow(hWnd, MONITOR_DEFAULTTONEAREST);
+        MONITORINFO monitorInfo;
+        if (::GetMonitorInfo(monitor, &monitorInfo) == FALSE)
+            return TaskbarPostion::kNoPos;
+        std::vector<TaskbarPostion> postitons = {
+            TaskbarPostion::kLeft, TaskbarPostion::kTop, TaskbarPostion::kRight,
+            TaskbarPostion::kBottom};
+        appbarData.rc = monitorInfo.rcMonitor;
+        for (auto pos : postitons)
+        {
+            appbarData.uEdge = static_cast<UINT>(pos);
+            if (::SHAppBarMessage(ABM_GETAUTOHIDEBAREX, &appbarData) != NULL)
+                return pos;
+        }
+
+        return TaskbarPostion::kNoPos;
+    }
+
+    appbarData.hWnd = ::FindWindow(TEXT("Shell_TrayWnd"), NULL);
+
+    if (appbarData.hWnd)
+    {
+        HMONITOR windowMonitor =
+            ::MonitorFromWindow(hWnd, MONITOR_DEFAULTTONEAREST);
+        HMONITOR taskbarMonitor =
+            ::MonitorFromWindow(appbarData.hWnd, MONITOR_DEFAULTTOPRIMARY);
+        if (windowMonitor && taskbarMonitor && windowMonitor == taskbarMonitor)
+        {
+            ::SHAppBarMessage(ABM_GETTASKBARPOS, &appbarData);
+            return static_cast<TaskbarPostion>(appbarData.uEdge);
+        }
+    }
+
+    return TaskbarPostion::kNoPos;
+}
+
+#endif
+
+CaptionButtonColors captionButtonColors(
+    CaptionButton button, TitleBarButtonState state)
+{
+    const bool isClose = button == CaptionButton::kClose;
+    switch (state)
+    {
+        case kHover:
+            return {
+                Qt::white,
+                isClose ? QColor(232, 17, 35) : QColor(0, 100, 182)};
+        case kPressed:
+            return {
+                Qt::white,
+                isClose ? QColor(241, 112, 122) : QColor(54, 57, 65)};
+        default:
+            return {QColor(0, 0, 0), QColor(0, 0, 0, 0)};
+    }
+}
+
+QRect captionButtonRect(CaptionButton button, int titleBarWidth)
+{
+    const int index = static_cast<int>(button);
+    return QRect(
+        titleBarWidth - (kCaptionButtonCount - index) * kTitleBarButtonWidth,
+        0, kTitleBarButtonWidth, kTitleBarHeight);
+}
+
+CaptionButton captionButtonAt(const QPoint &pos, int titleBarWidth)
+{
+    for (int i = 0; i < kCaptionButtonCount; ++i)
+    {
+        const CaptionButton button = static_cast<CaptionButton>(i);
+        if (captionButtonRect(button, titleBarWidth).contains(pos))
+            return button;
+    }
+    return CaptionButton::kNone;
+}
+
+bool isCaptionDragArea(const QPoint &pos, int titleBarWidth)
+{
+    return pos.y() < kTitleBarHeight && 0 < pos.x() &&
+           pos.x() < titleBarWidth - kCaptionButtonCount * kTitleBarButtonWidth;
+}
+
+Qt::Edges resizeEdgesAt(const QRect &geometry, const QPoint &globalPos)
+{
+    Qt::Edges edges;
+    if ((globalPos.x() - geometry.x()) < kResizeBorderWidth)
+        edges |= Qt::LeftEdge;
+    if ((globalPos.x() - geometry.x()) >
+        (geometry.width() - kResizeBorderWidth))
+        edges |= Qt::RightEdge;
+    if ((globalPos.y() - geometry.y()) < kResizeBorderWidth)
+        edges |= Qt::TopEdge;
+    if ((globalPos.y() - geometry.y()) >
+        (geometry.height() - kResizeBorderWidth))
+        edges |= Qt::BottomEdge;
+    return edges;
+}
+
+Qt::CursorShape cursorForEdges(Qt::Edges edges)
+{
+    if (edges == (Qt::LeftEdge | Qt::TopEdge) ||
+        edges == (Qt::RightEdge | Qt::BottomEdge))
+        return Qt::SizeFDiagCursor;
+    if (edges == (Qt::RightEdge | Qt::TopEdge) ||
+        edges == (Qt::LeftEdge | Qt::BottomEdge))
+        return Qt::SizeBDiagCursor;
+    if (edges & (Qt::LeftEdge | Qt::RightEdge))
+        return Qt::SizeHorCursor;
+    if (edges & (Qt::TopEdge | Qt::BottomEdge))
+        return Qt::SizeVerCursor;
+
+    return Qt::ArrowCursor;
+}
+
+bool isFramelessHintSupported()
+{
+#ifdef Q_OS_WIN
+    return isGreaterWin7();
+#else
+    return true;
+#endif
+}
+
+bool isCompositingSupported()
+{
+#ifdef Q_OS_WIN
+    return isCompositionEnabled();
+#else
+    const QString platform = QGuiApplication::platformName();
+    if (platform == QLatin1String("xcb"))
+    {
+#ifdef FRAMELESS_X11EXTRAS
+        return QX11Info::isCompositingManagerRunning();
+#else
+        // can't ask the window manager, assume the worst
+        return false;
+#endif
+    }
+    return platform != QLatin1String("offscreen") &&
+           platform != QLatin1String("minimal");
+#endif
+}
+
+void setupFramelessWindow(QWindow *window)
+{
+#ifdef Q_OS_WIN
+    HWND hWnd = reinterpret_cast<HWND>(window->winId());
+    addWindowAnimation(hWnd);
+    addShadowEffect(hWnd);
+#else
+    Q_UNUSED(window)
+#endif
+}
+
+void updateWindowFrame(QWindow *window)
+{
+#ifdef Q_OS_WIN
+    ChromeCounters::add(ChromeCounters::kFrameRecalc);
+    HWND hWnd = reinterpret_cast<HWND>(window->winId());
+    ::SetWindowPos(
+        hWnd, nullptr, 0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE | SWP_FRAMECHANGED);
+#else
+    Q_UNUSED(window)
+#endif
+}
+
+bool handleFramelessNativeEvent(
+    QWindow *window, void *message, long *result, bool resizeEnabled)
+{
+#ifdef Q_OS_WIN
+    MSG *msg = reinterpret_cast<MSG *>(message);
+    if (!msg->hwnd)
+        return false;
+
+    switch (msg->message)
+    {
+        case WM_NCHITTEST:
+        {
+            ChromeCounters::add(ChromeCounters::kHitTest);
+            if (!resizeEnabled)
+                break;
+            *result = HTBORDER;
+
+            QPoint cursor(
+                GET_X_LPARAM(msg->lParam), GET_Y_LPARAM(msg->lParam));
+            Qt::Edges edges = resizeEdgesAt(window->geometry(), cursor);
+
+            bool left = edges.testFlag(Qt::LeftEdge);
+            bool right = edges.testFlag(Qt::RightEdge);
+            bool top = edges.testFlag(Qt::TopEdge);
+            bool bottom = edges.testFlag(Qt::BottomEdge);
+
+            if (left && top)
+                *result = HTTOPLEFT;
+            else if (left && bottom)
+                *result = HTBOTTOMLEFT;
+            else if (right && top)
+                *result = HTTOPRIGHT;
+            else if (right && bottom)
+                *result = HTBOTTOMRIGHT;
+            else if (top)
+                *result = HTTOP;
+            else if (bottom)
+                *result = HTBOTTOM;
+            else if (left)
+                *result = HTLEFT;
+            else if (right)
+                *result = HTRIGHT;
+
+            if (left || right || top || bottom)
+                return true;
+
+            break;
+        }
+        case WM_NCCALCSIZE:
+        {
+            ChromeCounters::add(ChromeCounters::kFrameRecalc);
+            LPRECT rect;
+            if (msg->wParam == TRUE)
+            {
+                rect = reinterpret_cast<LPRECT>(msg->lParam);
+            }
+            else if (msg->wParam == FALSE)
+            {
+                rect = &(reinterpret_cast<LPNCCALCSIZE_PARAMS>(msg->lParam)
+                             ->rgrc[0]);
+            }
+            else
+            {
+                *result = 0;
+                return true;
+            }
+
+            bool max = (IsMaximized(msg->hwnd) == TRUE);
+            bool fullScreen = isFullScreenWin(msg->hwnd);
+
+            if (max && !fullScreen)
+            {
+                int borderY = getResizeBorderThickness(msg->hwnd, false);
+                rect->top += borderY;
+                rect->bottom -= borderY;
+
+                int borderX = getResizeBorderThickness(msg->hwnd, true);
+                rect->left += borderX;
+                rect->right -= borderX;
+            }
+
+            if ((max || fullScreen) && isTaskbarAutoHide())
+            {
+                TaskbarPostion pos = getTaskbarPosition(msg->hwnd);
+                switch (pos)
+                {
+                    case TaskbarPostion::kLeft:
+                        rect->left += kTaskbarAutoHideThickness;
+                        break;
+                    case TaskbarPostion::kRight:
+                        rect->right -= kTaskbarAutoHideThickness;
+                        break;
+                    case TaskbarPostion::kTop:
+                        rect->top += kTaskbarAutoHideThickness;
+                        break;
+                    case TaskbarPostion::kBottom:
+                        rect->bottom -= kTaskbarAutoHideThickness;
+                        break;
+                }
+            }
+
+            if (msg->wParam == FALSE)
+                *result = 0;
+            else
+                *result = WVR_REDRAW;
+
+            return true;
+        }
+    }
+#else
+    Q_UNUSED(window)
+    Q_UNUSED(message)
+    Q_UNUSED(result)
+    Q_UNUSED(resizeEnabled)
+#endif
+    return false;
+}
@@ -0,0 +1,82 @@
+#ifndef FRAMELESSHELPER_H
+#define FRAMELESSHELPER_H
+
+#include <QColor>
+#include <QPoint>
+#include <QRect>
+
+class QWindow;
+
+// Shared by the QWidget and QWindow based frameless windows.
+
+constexpr int kResizeBorderWidth = 5;
+constexpr int kTitleBarHeight = 32;
+constexpr int kTitleBarButtonWidth = 46;
+
+enum TitleBarButtonState
+{
+    kNormal = 0,
+    kHover,
+    kPressed
+};
+
+// Caption buttons from left to right, they sit at the right end of every
+// title bar.
+enum class CaptionButton
+{
+    kNone = -1,
+    kMinimize = 0,
+    kMaximize,
+    kClose
+};
+
+constexpr int kCaptionButtonCount = 3;
+
+struct CaptionButtonColors
+{
+    QColor icon;
+    QColor background;
+};
+
+// Colors of |button| in |state|, the one palette of TitleBar,
+// FramelessWindow and TitleBarButtonItem.
+CaptionButtonColors captionButtonColors(
+    CaptionButton button, TitleBarButtonState state);
+
+// Rect of |button| in a title bar that is |titleBarWidth| wide.
+QRect captionButtonRect(CaptionButton button, int titleBarWidth);
+
+// Caption button at |pos| in title bar coordinates, CaptionButton::kNone
+// when there is none.
+CaptionButton captionButtonAt(const QPoint &pos, int titleBarWidth);
+
+// Whether |pos| is in the title bar left of the caption buttons, where a
+// press moves the window unless an item of the title bar takes it.
+bool isCaptionDragArea(const QPoint &pos, int titleBarWidth);
+
+// Returns the edges of |geometry| that |globalPos| is close enough to for
+// resizing.
+Qt::Edges resizeEdgesAt(const QRect &geometry, const QPoint &globalPos);
+
+// Resize cursor for |edges|, Qt::ArrowCursor without edges.
+Qt::CursorShape cursorForEdges(Qt::Edges edges);
+
+// Whether Qt::FramelessWindowHint alone keeps the native window behaviour.
+bool isFramelessHintSupported();
+
+// Whether a compositor blends top level windows, which window opacity and
+// translucent top level windows need.
+bool isCompositingSupported();
+
+// Restores the native animations and shadow of a frameless window.
+void setupFramelessWindow(QWindow *window);
+
+// Makes the system recalculate the window frame, e.g. after a screen change.
+void updateWindowFrame(QWindow *window);
+
+// Handles hit testing and the non-client area of a frameless window. Returns
+// true when the message was consumed and |result| was set.
+bool handleFramelessNativeEvent(
+    QWindow *window, void *message, long *result, bool resizeEnabled);
+
+#endif  // FRAMELESSHELPER_H
@@ -0,0 +1,153 @@
+#include "framelessquickwindow.h"
+
+#include <QMouseEvent>
+#include <QQuickItem>
+#include <QtQml>
+
+#include "framelesshelper.h"
+#include "titlebarbuttonitem.h"
+
+// Whether an enabled item under |pos| takes mouse presses, in which case
+// the press is not a caption drag.
+static bool hasInteractiveItemAt(QQuickItem *item, const QPointF &scenePos)
+{
+    if (!item->isVisible() || !item->isEnabled())
+        return false;
+
+    const QList<QQuickItem *> children = item->childItems();
+    for (int i = children.size() - 1; i >= 0; --i)
+    {
+        if (hasInteractiveItemAt(children.at(i), scenePos))
+            return true;
+    }
+    return item->acceptedMouseButtons() != Qt::NoButton &&
+           item->contains(item->mapFromScene(scenePos));
+}
+
+FramelessQuickWindow::FramelessQuickWindow(QWindow *parent)
+    : QQuickWindow(parent), m_isResizeEnable(true), m_hasResizeCursor(false)
+{
+    if (isFramelessHintSupported())
+        setFlags(flags() | Qt::FramelessWindowHint);
+    else
+        setFlags(Qt::FramelessWindowHint | Qt::WindowMaximizeButtonHint);
+
+    setColor(Qt::white);
+    connect(
+        this, &QWindow::screenChanged, this,
+        &FramelessQuickWindow::onScreenChanged);
+
+#ifdef Q_OS_WIN
+    setupFramelessWindow(this);
+#endif
+}
+
+bool FramelessQuickWindow::isResizeEnabled() const
+{
+    return m_isResizeEnable;
+}
+
+void FramelessQuickWindow::setResizeEnabled(bool enable)
+{
+    if (m_isResizeEnable == enable)
+        return;
+
+    m_isResizeEnable = enable;
+    emit resizeEnabledChanged();
+}
+
+int FramelessQuickWindow::titleBarHeight() const
+{
+    return kTitleBarHeight;
+}
+
+void FramelessQuickWindow::toggleMaxState()
+{
+    if (windowStates().testFlag(Qt::WindowMaximized))
+        showNormal();
+    else
+        showMaximized();
+}
+
+void FramelessQuickWindow::mousePressEvent(QMouseEvent *event)
+{
+#ifndef Q_OS_WIN
+    // Windows resizes through WM_NCHITTEST instead.
+    const Qt::Edges edges = resizeEdgesAt(geometry(), event->globalPos());
+    if (event->button() == Qt::LeftButton && m_isResizeEnable && edges &&
+        !(windowStates() & (Qt::WindowMaximized | Qt::WindowFullScreen)))
+    {
+        startSystemResize(edges);
+        return;
+    }
+#endif
+
+    if (event->button() == Qt::LeftButton && isDragRegion(event->pos()))
+    {
+        startSystemMove();
+        return;
+    }
+    QQuickWindow::mousePressEvent(event);
+}
+
+void FramelessQuickWindow::mouseMoveEvent(QMouseEvent *event)
+{
+#ifndef Q_OS_WIN
+    // Only touches the cursor near the edges, items set their own elsewhere.
+    const Qt::Edges edges = m_isResizeEnable
+                                ? resizeEdgesAt(geometry(), event->globalPos())
+                                : Qt::Edges();
+    if (edges)
+    {
+        setCursor(cursorForEdges(edges));
+        m_hasResizeCursor = true;
+    }
+    else if (m_hasResizeCursor)
+    {
+        unsetCursor();
+        m_hasResizeCursor = false;
+    }
+#endif
+    QQuickWindow::mouseMoveEvent(event);
+}
+
+void FramelessQuickWindow::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton && isDragRegion(event->pos()))
+    {
+        toggleMaxState();
+        return;
+    }
+    QQuickWindow::mouseDoubleClickEvent(event);
+}
+
+bool FramelessQuickWindow::nativeEvent(
+    const QByteArray &eventType, void *message, long *result)
+{
+    if (handleFramelessNativeEvent(this, message, result, m_isResizeEnable))
+        return true;
+
+    return QQuickWindow::nativeEvent(eventType, message, result);
+}
+
+void FramelessQuickWindow::onScreenChanged(QScreen *screen)
+{
+    Q_UNUSED(screen)
+#ifdef Q_OS_WIN
+    updateWindowFrame(this);
+#endif
+}
+
+bool FramelessQuickWindow::isDragRegion(const QPoint &pos) const
+{
+    return isCaptionDragArea(pos, width()) &&
+           !hasInteractiveItemAt(contentItem(), pos);
+}
+
+void registerFramelessQuickTypes()
+{
+    qmlRegisterType<FramelessQuickWindow>(
+        "FramelessWindow", 1, 0, "FramelessWindow");
+    qmlRegisterType<TitleBarButtonItem>(
+        "FramelessWindow", 1, 0, "TitleBarButton");
+}
@@ -0,0 +1,52 @@
+#ifndef FRAMELESSQUICKWINDOW_H
+#define FRAMELESSQUICKWINDOW_H
+
+#include <QQuickWindow>
+
+class QQuickItem;
+
+// Frameless QQuickWindow for QML tools, with the hit testing, moving and
+// resizing of FramelessWindow. Presses in the top titleBarHeight pixels
+// drag the window unless an item there accepts mouse buttons, so title bar
+// buttons and other controls keep working.
+class FramelessQuickWindow : public QQuickWindow
+{
+    Q_OBJECT
+    Q_PROPERTY(bool resizeEnabled READ isResizeEnabled WRITE setResizeEnabled
+                   NOTIFY resizeEnabledChanged)
+    Q_PROPERTY(int titleBarHeight READ titleBarHeight CONSTANT)
+public:
+    explicit FramelessQuickWindow(QWindow *parent = nullptr);
+
+    bool isResizeEnabled() const;
+    void setResizeEnabled(bool enable);
+    int titleBarHeight() const;
+
+    Q_INVOKABLE void toggleMaxState();
+
+signals:
+    void resizeEnabledChanged();
+
+protected:
+    virtual void mousePressEvent(QMouseEvent *event) override;
+    virtual void mouseMoveEvent(QMouseEvent *event) override;
+    virtual void mouseDoubleClickEvent(QMouseEvent *event) override;
+    virtual bool nativeEvent(
+        const QByteArray &eventType, void *message, long *result) override;
+
+private slots:
+    void onScreenChanged(QScreen *screen);
+
+private:
+    bool isDragRegion(const QPoint &pos) const;
+
+private:
+    bool m_isResizeEnable;
+    bool m_hasResizeCursor;
+};
+
+// Registers FramelessWindow and TitleBarButton in the FramelessWindow 1.0
+// QML module.
+void registerFramelessQuickTypes();
+
+#endif  // FRAMELESSQUICKWINDOW_H
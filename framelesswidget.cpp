@@ -1,379 +1,439 @@
 #include "framelesswidget.h"
 
-#include <cmath>
-#include <vector>
-
-#ifdef Q_OS_WIN
-#include <Windows.h>
-#include <dwmapi.h>
-#include <windowsx.h>
-#include <wingdi.h>
-#endif
+#include "chromecounters.h"
+#include "chrometrace.h"
+#include "framelesshelper.h"
 
+#include <QChildEvent>
 #include <QDebug>
 #include <QGuiApplication>
-#include <QOperatingSystemVersion>
+#include <QMoveEvent>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QPixmap>
+#include <QPixmapCache>
+#include <QResizeEvent>
 #include <QScreen>
 #include <QWindow>
 
-#ifdef Q_OS_WIN
-constexpr int kBorderWidth = 5;
-constexpr int kTaskbarAutoHideThickness = 2;
-
-enum class TaskbarPostion
+enum class Corner
 {
-    kLeft = 0,
-    kTop = 1,
-    kRight = 2,
-    kBottom = 3,
-    kNoPos = 4
+    kTopLeft = 0,
+    kTopRight = 1,
+    kBottomLeft = 2,
+    kBottomRight = 3
 };
 
-bool isFullScreenWin(HWND hWnd)
+// Corner pieces are alpha masks that only depend on radius and device pixel
+// ratio, so they are rendered once and shared by every window through
+// QPixmapCache.
+QPixmap cornerPixmap(Corner corner, int radius, qreal dpr)
 {
-    RECT winRect;
-    ::GetWindowRect(hWnd, &winRect);
-
-    HMONITOR monitor = ::MonitorFromWindow(hWnd, MONITOR_DEFAULTTOPRIMARY);
-    MONITORINFO monitorInfo;
-    if (::GetMonitorInfo(monitor, &monitorInfo) == FALSE)
-        return false;
-
-    RECT monitorRect = monitorInfo.rcMonitor;
+    const QString key = QStringLiteral("frameless_corner_%1_%2_%3")
+                            .arg(static_cast<int>(corner))
+                            .arg(radius)
+                            .arg(dpr);
+    QPixmap pixmap;
+    if (QPixmapCache::find(key, &pixmap))
+        return pixmap;
+
+    const int size = qRound(radius * dpr);
+    pixmap = QPixmap(size, size);
+    pixmap.setDevicePixelRatio(dpr);
+    pixmap.fill(Qt::transparent);
+
+    QPointF center;
+    switch (corner)
+    {
+        case Corner::kTopLeft:
+            center = QPointF(radius, radius);
+            break;
+        case Corner::kTopRight:
+            center = QPointF(0, radius);
+            break;
+        case Corner::kBottomLeft:
+            center = QPointF(radius, 0);
+            break;
+        case Corner::kBottomRight:
+            center = QPointF(0, 0);
+            break;
+    }
 
-    if (monitorRect.top == winRect.top &&
-        monitorRect.bottom == winRect.bottom &&
-        monitorRect.left == winRect.left && monitorRect.right == winRect.right)
-        return true;
+    QPainter painter(&pixmap);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(Qt::black);
+    painter.drawEllipse(center, radius, radius);
+    painter.end();
 
-    return false;
+    QPixmapCache::insert(key, pixmap);
+    return pixmap;
 }
 
-QWindow *findWindow(HWND hWnd)
+// Cuts one rounded corner out of everything painted below it. It is raised
+// above the other children, so the title bar, its buttons and the content
+// are clipped as well, which the window's own paint pass can't do.
+class CornerOverlay : public QWidget
 {
-    if (!hWnd)
-        return nullptr;
-
-    QWindowList windows = QGuiApplication::topLevelWindows();
+public:
+    CornerOverlay(Corner corner, QWidget *parent)
+        : QWidget(parent), m_corner(corner), m_radius(0)
+    {
+        setAttribute(Qt::WA_TransparentForMouseEvents);
+        setAttribute(Qt::WA_NoSystemBackground);
+        hide();
+    }
 
-    if (windows.count() == 0)
-        return 0;
+    void setRadius(int radius)
+    {
+        m_radius = radius;
+        resize(radius, radius);
+    }
 
-    for (auto window : windows)
+protected:
+    virtual void paintEvent(QPaintEvent *event) override
     {
-        if (window && reinterpret_cast<HWND>(window->winId()) == hWnd)
-            return window;
+        Q_UNUSED(event)
+        if (m_radius <= 0)
+            return;
+
+        // The piece is qRound(radius * dpr) device pixels, draw it into the
+        // exact logical square.
+        const QPixmap pixmap =
+            cornerPixmap(m_corner, m_radius, devicePixelRatioF());
+        QPainter painter(this);
+        painter.setCompositionMode(QPainter::CompositionMode_DestinationIn);
+        painter.drawPixmap(QRectF(rect()), pixmap, QRectF(pixmap.rect()));
     }
-}
 
-int getDpiForWindow(HWND hWnd, bool horizontal)
+private:
+    Corner m_corner;
+    int m_radius;
+};
+
+FramelessWidget::FramelessWidget(QWidget *parent, int cornerRadius)
+    : QWidget(parent),
+      m_titleBar(nullptr),
+      m_isResizeEnable(true),
+      m_cornerRadius(0),
+      m_backdropTint(255, 255, 255, 180),
+      m_cornerOverlays()
 {
-#if (WINVER >= 0x0605)
-    return ::GetDpiForWindow(hWnd);
+    // created here, childEvent() runs for it and needs the members set up
+    m_titleBar = new TitleBar(this);
+    setAttribute(Qt::WA_NativeWindow);
+    setAttribute(Qt::WA_DontCreateNativeAncestors);
+
+    if (isFramelessHintSupported())
+        setWindowFlags(windowFlags() | Qt::FramelessWindowHint);
+    else if (parent)
+        setWindowFlags(parent->windowFlags() | Qt::FramelessWindowHint);
+    else
+        setWindowFlags(Qt::FramelessWindowHint | Qt::WindowMaximizeButtonHint);
+
+    resize(500, 500);
+    connect(
+        m_titleBar, &TitleBar::windowStateChanged, this,
+        &FramelessWidget::onWindowStateChanged);
+    m_titleBar->raise();
+
+    for (int i = 0; i < 4; ++i)
+        m_cornerOverlays[i] = new CornerOverlay(static_cast<Corner>(i), this);
+    // before winId(), so a rounded window is created translucent
+    setCornerRadius(cornerRadius);
+#ifdef Q_OS_WIN
+    winId();
+    connect(
+        windowHandle(), &QWindow::screenChanged, this,
+        &FramelessWidget::onScreenChanged);
+    setupFramelessWindow(windowHandle());
 #endif
-    HDC hdc = ::GetDC(hWnd);
-    int dpiX = ::GetDeviceCaps(hdc, LOGPIXELSX);
-    int dpiY = ::GetDeviceCaps(hdc, LOGPIXELSY);
-    ReleaseDC(hWnd, hdc);
-    if (dpiX > 0 && horizontal)
-        return dpiX;
-    else if (dpiY > 0 && !horizontal)
-        return dpiY;
-
-    return 96;
 }
 
-int getSystemMetrics(HWND hWnd, int index, bool horizontal)
+FramelessWidget::~FramelessWidget() {}
+
+void FramelessWidget::setTitleBar(TitleBar *titleBar)
 {
-#if (WINVER >= 0x0605)
-    int dpi = getDpiForWindow(hWnd, horizontal);
-    return ::GetSystemMetricsForDpi(index, dpi);
-#endif
-    return ::GetSystemMetrics(index);
+    if (!titleBar || m_titleBar == titleBar)
+        return;
+
+    m_titleBar->deleteLater();
+    m_titleBar = titleBar;
+    m_titleBar->setParent(this);
+    connect(
+        m_titleBar, &TitleBar::windowStateChanged, this,
+        &FramelessWidget::onWindowStateChanged);
+    m_titleBar->raise();
+    updateCornerOverlays();
 }
 
-bool isCompositionEnabled()
+TitleBar *FramelessWidget::titleBar() const
 {
-    BOOL result = FALSE;
-    bool success = (::DwmIsCompositionEnabled(&result) == S_OK);
-    return (result == TRUE) && success;
+    return m_titleBar;
 }
 
-int getResizeBorderThickness(HWND hWnd, bool horizontal)
+void FramelessWidget::setResizeEnabled(bool enable)
 {
-    QWindow *window = findWindow(hWnd);
-    if (!window)
-        return 0;
+    m_isResizeEnable = enable;
+}
 
-    int frame = SM_CYSIZEFRAME;
-    if (horizontal)
-        frame = SM_CXSIZEFRAME;
+void FramelessWidget::setCornerRadius(int radius)
+{
+    radius = qMax(0, radius);
+    if (m_cornerRadius == radius)
+        return;
 
-    int result = getSystemMetrics(hWnd, frame, horizontal) +
-                 getSystemMetrics(hWnd, 92, horizontal);
+    // The background outside the corners has to stay transparent, which the
+    // native window only supports when it is created that way.
+    if (testAttribute(Qt::WA_WState_Created) &&
+        testAttribute(Qt::WA_TranslucentBackground) != (radius > 0))
+        qWarning("FramelessWidget: pass the corner radius to the constructor");
+
+    m_cornerRadius = radius;
+    // The body is a flat fill, so only newly exposed areas need paint.
+    setAttribute(Qt::WA_TranslucentBackground, radius > 0);
+    setAttribute(Qt::WA_StaticContents, radius > 0);
+    updateCornerOverlays();
+    update();
+}
 
-    if (result > 0)
-        return result;
+int FramelessWidget::cornerRadius() const
+{
+    return m_cornerRadius;
+}
 
-    int thickness = 8;
-    if (!isCompositionEnabled())
-        thickness = 4;
+void FramelessWidget::setBackdropImage(const QImage &image)
+{
+    m_backdrop.setSource(image);
+    update();
+}
 
-    return std::round(thickness * window->devicePixelRatio());
+void FramelessWidget::updateBackdropImage(
+    const QImage &image, const QRect &dirtyRect)
+{
+    m_backdrop.updateSource(image, dirtyRect);
+    update();
 }
 
-void addWindowAnimation(HWND hWnd)
+void FramelessWidget::setBackdropBlurRadius(int radius)
 {
-    LONG style = ::GetWindowLong(hWnd, GWL_STYLE);
-    ::SetWindowLong(
-        hWnd, GWL_STYLE,
-        style | WS_MINIMIZEBOX | WS_MAXIMIZEBOX | WS_CAPTION | CS_DBLCLKS |
-            WS_THICKFRAME);
+    m_backdrop.setRadius(radius);
+    update();
 }
 
-void addShadowEffect(HWND hWnd)
+void FramelessWidget::setBackdropTint(const QColor &tint)
 {
-    if (!isCompositionEnabled())
+    if (m_backdropTint == tint)
         return;
 
-    MARGINS margins;
-    margins.cxLeftWidth = -1;
-    margins.cyTopHeight = -1;
-    margins.cxRightWidth = -1;
-    margins.cyBottomHeight = -1;
-    ::DwmExtendFrameIntoClientArea(hWnd, &margins);
+    m_backdropTint = tint;
+    update();
 }
 
-bool isTaskbarAutoHide()
+ChromeMemoryUsage FramelessWidget::memoryUsage() const
 {
-    APPBARDATA appbarData;
-    memset(&appbarData, 0, sizeof(APPBARDATA));
-    appbarData.cbSize = sizeof(APPBARDATA);
-    UINT_PTR taskbarState = ::SHAppBarMessage(ABM_GETSTATE, &appbarData);
-    return (taskbarState == ABS_AUTOHIDE);
+    ChromeMemoryUsage usage;
+    usage.titleBar = m_titleBar->memoryUsage();
+    usage.backdrop = m_backdrop.cachedBytes();
+    if (testAttribute(Qt::WA_WState_Created))
+    {
+        const qreal dpr = devicePixelRatioF();
+        usage.backingStore =
+            qint64(width() * dpr) * qint64(height() * dpr) * 4;
+    }
+    return usage;
 }
 
-bool isGreaterEqualWin8_1()
+void FramelessWidget::releaseResources()
 {
-    return QOperatingSystemVersion::current() >=
-           QOperatingSystemVersion::Windows8_1;
+    m_titleBar->releaseResources();
+    m_backdrop.releaseCache();
 }
 
-bool isGreaterWin7()
+void FramelessWidget::restoreResources()
 {
-    return QOperatingSystemVersion::current() >
-           QOperatingSystemVersion::Windows7;
+    // the backdrop tiles and svg icons come back on the next paint
+    m_titleBar->restoreResources();
 }
 
-TaskbarPostion getTaskbarPosition(HWND hWnd)
+void FramelessWidget::paintEvent(QPaintEvent *event)
 {
-    APPBARDATA appbarData;
-    memset(&appbarData, 0, sizeof(APPBARDATA));
-    appbarData.cbSize = sizeof(APPBARDATA);
-    if (isGreaterEqualWin8_1())
+    if (m_cornerRadius <= 0 && m_backdrop.isNull())
     {
-        HMONITOR monitor = ::MonitorFromWindow(hWnd, MONITOR_DEFAULTTONEAREST);
-        MONITORINFO monitorInfo;
-        if (::GetMonitorInfo(monitor, &monitorInfo) == FALSE)
-            return TaskbarPostion::kNoPos;
-        std::vector<TaskbarPostion> postitons = {
-            TaskbarPostion::kLeft, TaskbarPostion::kTop, TaskbarPostion::kRight,
-            TaskbarPostion::kBottom};
-        appbarData.rc = monitorInfo.rcMonitor;
-        for (auto pos : postitons)
-        {
-            appbarData.uEdge = static_cast<UINT>(pos);
-            if (::SHAppBarMessage(ABM_GETAUTOHIDEBAREX, &appbarData) != NULL)
-                return pos;
-        }
-
-        return TaskbarPostion::kNoPos;
+        QWidget::paintEvent(event);
+        return;
     }
 
-    appbarData.hWnd = ::FindWindow(TEXT("Shell_TrayWnd"), NULL);
+    // The corners are cut by the overlays after the children painted.
+    QPainter painter(this);
+    if (m_backdrop.isNull())
+        painter.fillRect(rect(), palette().color(backgroundRole()));
+    else
+        paintBackdrop(&painter, event->rect());
+}
 
-    if (appbarData.hWnd)
-    {
-        HMONITOR windowMonitor =
-            ::MonitorFromWindow(hWnd, MONITOR_DEFAULTTONEAREST);
-        HMONITOR taskbarMonitor =
-            ::MonitorFromWindow(appbarData.hWnd, MONITOR_DEFAULTTOPRIMARY);
-        if (windowMonitor && taskbarMonitor && windowMonitor == taskbarMonitor)
-        {
-            ::SHAppBarMessage(ABM_GETTASKBARPOS, &appbarData);
-            return static_cast<TaskbarPostion>(appbarData.uEdge);
-        }
-    }
+void FramelessWidget::moveEvent(QMoveEvent *event)
+{
+    QWidget::moveEvent(event);
+    if (m_backdrop.isNull() || !isVisible() || isMinimized())
+        return;
+
+    // Moving shows another part of the backdrop, only tiles that were never
+    // visible before get blurred. Nothing changes unless the window landed
+    // on other device pixels, and opaque children don't show the backdrop.
+    const QPoint globalPos = mapToGlobal(QPoint(0, 0));
+    const QPoint delta = event->pos() - event->oldPos();
+    if (backdropPosition(globalPos) == backdropPosition(globalPos - delta))
+        return;
 
-    return TaskbarPostion::kNoPos;
+    update(backdropRegion());
 }
 
-#endif
+void FramelessWidget::resizeEvent(QResizeEvent *event)
+{
+    CHROME_TRACE_SCOPE("FramelessWidget::resizeEvent");
+    ChromeCounters::add(ChromeCounters::kResize);
+    QWidget::resizeEvent(event);
+    m_titleBar->resize(width(), m_titleBar->height());
+    // Moving the overlays repaints the old corners, which are now body.
+    updateCornerOverlays();
+}
 
-FramelessWidget::FramelessWidget(QWidget *parent)
-    : QWidget(parent), m_titleBar(new TitleBar(this)), m_isResizeEnable(true)
+void FramelessWidget::showEvent(QShowEvent *event)
 {
-    setAttribute(Qt::WA_NativeWindow);
-    setAttribute(Qt::WA_DontCreateNativeAncestors);
+    QWidget::showEvent(event);
+    if (!isMinimized())
+        restoreResources();
+}
 
-    if (isGreaterWin7())
-        setWindowFlags(windowFlags() | Qt::FramelessWindowHint);
-    else if (parent)
-        setWindowFlags(parent->windowFlags() | Qt::FramelessWindowHint);
-    else
-        setWindowFlags(Qt::FramelessWindowHint | Qt::WindowMaximizeButtonHint);
+void FramelessWidget::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    releaseResources();
+}
 
-    resize(500, 500);
-#ifdef Q_OS_WIN
-    connect(
-        windowHandle(), &QWindow::screenChanged, this,
-        &FramelessWidget::onScreenChanged);
-    addWindowAnimation(reinterpret_cast<HWND>(winId()));
-    addShadowEffect(reinterpret_cast<HWND>(winId()));
-#endif
-    m_titleBar->raise();
+bool FramelessWidget::nativeEvent(
+    const QByteArray &eventType, void *message, long *result)
+{
+    CHROME_TRACE_SCOPE("FramelessWidget::nativeEvent");
+    if (handleFramelessNativeEvent(
+            windowHandle(), message, result, m_isResizeEnable))
+        return true;
+
+    return QWidget::nativeEvent(eventType, message, result);
 }
 
-FramelessWidget::~FramelessWidget() {}
+void FramelessWidget::childEvent(QChildEvent *event)
+{
+    QWidget::childEvent(event);
+    // keep the corner overlays above children added later
+    if (event->added() && m_cornerOverlays[0] && m_cornerRadius > 0)
+        updateCornerOverlays();
+}
 
-void FramelessWidget::setTitleBar(TitleBar *titleBar)
+void FramelessWidget::onScreenChanged(QScreen *screen)
 {
-    if (!titleBar || m_titleBar == titleBar)
-        return;
+    CHROME_TRACE_SCOPE("FramelessWidget::onScreenChanged");
+    Q_UNUSED(screen)
+    updateWindowFrame(windowHandle());
+}
 
-    m_titleBar->deleteLater();
-    m_titleBar = titleBar;
-    m_titleBar->setParent(this);
-    m_titleBar->raise();
+void FramelessWidget::onWindowStateChanged(Qt::WindowStates state)
+{
+    if (state & Qt::WindowMinimized)
+        releaseResources();
+    else if (isVisible())
+        restoreResources();
+
+    updateCornerOverlays();
 }
 
-void FramelessWidget::setResizeEnabled(bool enable)
+bool FramelessWidget::hasRoundedCorners() const
 {
-    m_isResizeEnable = enable;
+    return m_cornerRadius > 0 &&
+           !(windowState() & (Qt::WindowMaximized | Qt::WindowFullScreen));
 }
 
-void FramelessWidget::resizeEvent(QResizeEvent *event)
+int FramelessWidget::effectiveCornerRadius(const QSize &size) const
 {
-    QWidget::resizeEvent(event);
-    m_titleBar->resize(width(), m_titleBar->height());
+    return qMin(m_cornerRadius, qMin(size.width(), size.height()) / 2);
 }
 
-bool FramelessWidget::nativeEvent(
-    const QByteArray &eventType, void *message, long *result)
+void FramelessWidget::updateCornerOverlays()
 {
-#ifdef Q_OS_WIN
-    MSG *msg = reinterpret_cast<MSG *>(message);
-    if (!msg->hwnd)
-        return QWidget::nativeEvent(eventType, message, result);
+    const int r = hasRoundedCorners() ? effectiveCornerRadius(size()) : 0;
+    const QPoint positions[4] = {
+        QPoint(0, 0), QPoint(width() - r, 0), QPoint(0, height() - r),
+        QPoint(width() - r, height() - r)};
+    for (int i = 0; i < 4; ++i)
+    {
+        CornerOverlay *overlay = m_cornerOverlays[i];
+        overlay->setVisible(r > 0);
+        if (r <= 0)
+            continue;
+
+        overlay->setRadius(r);
+        overlay->move(positions[i]);
+        overlay->raise();
+    }
+}
+
+QScreen *FramelessWidget::screenAt(const QPoint &globalPos) const
+{
+    if (QScreen *screen = QGuiApplication::screenAt(globalPos))
+        return screen;
+    if (windowHandle() && windowHandle()->screen())
+        return windowHandle()->screen();
+    return QGuiApplication::primaryScreen();
+}
 
-    switch (msg->message)
+// The backdrop is a device pixel grab of the whole virtual desktop with its
+// top left corner at 0,0. Screens keep their logical top left as native
+// position and each has its own scale, so |globalPos| is scaled relative to
+// the screen it is on, which also works for negative screen origins.
+QPointF FramelessWidget::backdropPosition(const QPoint &globalPos) const
+{
+    QPoint desktopOrigin =
+        QGuiApplication::primaryScreen()->geometry().topLeft();
+    for (const QScreen *screen : QGuiApplication::screens())
     {
-        case WM_NCHITTEST:
-        {
-            if (!m_isResizeEnable)
-                break;
-            *result = HTBORDER;
-
-            int cursorX = GET_X_LPARAM(msg->lParam);
-            int cursorY = GET_Y_LPARAM(msg->lParam);
-
-            bool left = (cursorX - x()) < kBorderWidth;
-            bool right = (cursorX - x()) > (width() - kBorderWidth);
-            bool top = (cursorY - y()) < kBorderWidth;
-            bool bottom = (cursorY - y()) > (height() - kBorderWidth);
-
-            if (left && top)
-                *result = HTTOPLEFT;
-            else if (left && bottom)
-                *result = HTBOTTOMLEFT;
-            else if (right && top)
-                *result = HTTOPRIGHT;
-            else if (right && bottom)
-                *result = HTBOTTOMRIGHT;
-            else if (top)
-                *result = HTTOP;
-            else if (bottom)
-                *result = HTBOTTOM;
-            else if (left)
-                *result = HTLEFT;
-            else if (right)
-                *result = HTRIGHT;
-
-            if (left || right || top || bottom)
-                return true;
+        const QPoint topLeft = screen->geometry().topLeft();
+        desktopOrigin.setX(qMin(desktopOrigin.x(), topLeft.x()));
+        desktopOrigin.setY(qMin(desktopOrigin.y(), topLeft.y()));
+    }
 
-            break;
-        }
-        case WM_NCCALCSIZE:
-        {
-            LPRECT rect;
-            if (msg->wParam == TRUE)
-            {
-                rect = reinterpret_cast<LPRECT>(msg->lParam);
-            }
-            else if (msg->wParam == FALSE)
-            {
-                rect = &(reinterpret_cast<LPNCCALCSIZE_PARAMS>(msg->lParam)
-                             ->rgrc[0]);
-            }
-            else
-            {
-                *result = 0;
-                return true;
-            }
-
-            bool max = (IsMaximized(msg->hwnd) == TRUE);
-            bool fullScreen = isFullScreenWin(msg->hwnd);
-
-            if (max && !fullScreen)
-            {
-                int borderY = getResizeBorderThickness(msg->hwnd, false);
-                rect->top += borderY;
-                rect->bottom -= borderY;
-
-                int borderX = getResizeBorderThickness(msg->hwnd, true);
-                rect->left += borderX;
-                rect->right -= borderX;
-            }
-
-            if ((max || fullScreen) && isTaskbarAutoHide())
-            {
-                TaskbarPostion pos = getTaskbarPosition(msg->hwnd);
-                switch (pos)
-                {
-                    case TaskbarPostion::kLeft:
-                        rect->left += kTaskbarAutoHideThickness;
-                        break;
-                    case TaskbarPostion::kRight:
-                        rect->right -= kTaskbarAutoHideThickness;
-                        break;
-                    case TaskbarPostion::kTop:
-                        rect->top += kTaskbarAutoHideThickness;
-                        break;
-                    case TaskbarPostion::kBottom:
-                        rect->bottom -= kTaskbarAutoHideThickness;
-                        break;
-                }
-            }
-
-            if (msg->wParam == FALSE)
-                *result = 0;
-            else
-                *result = WVR_REDRAW;
-
-            return true;
-        }
+    const QScreen *screen = screenAt(globalPos);
+    const QPoint screenOrigin = screen->geometry().topLeft();
+    return QPointF(screenOrigin - desktopOrigin) +
+           QPointF(globalPos - screenOrigin) * screen->devicePixelRatio();
+}
+
+QRegion FramelessWidget::backdropRegion() const
+{
+    QRegion region(rect());
+    for (QObject *child : children())
+    {
+        const QWidget *widget = qobject_cast<QWidget *>(child);
+        if (widget && widget->isVisible() &&
+            (widget->autoFillBackground() ||
+             widget->testAttribute(Qt::WA_OpaquePaintEvent)))
+            region -= widget->geometry();
     }
-#endif
-    return QWidget::nativeEvent(eventType, message, result);
+    return region;
 }
 
-void FramelessWidget::onScreenChanged(QScreen *screen)
+void FramelessWidget::paintBackdrop(QPainter *painter, const QRect &rect)
 {
-#ifdef Q_OS_WIN
-    Q_UNUSED(screen)
-    HWND hWnd = reinterpret_cast<HWND>(windowHandle()->winId());
-    ::SetWindowPos(
-        hWnd, nullptr, 0, 0, 0, 0, SWP_NOMOVE | SWP_NOSIZE | SWP_FRAMECHANGED);
-#endif
+    const QImage &source = m_backdrop.source();
+    const QPoint globalPos = mapToGlobal(rect.topLeft());
+    const QScreen *screen = screenAt(globalPos);
+    const QRectF sourceRect(
+        backdropPosition(globalPos),
+        QSizeF(rect.size()) * screen->devicePixelRatio());
+    if (!QRectF(source.rect()).contains(sourceRect))
+        painter->fillRect(rect, palette().color(backgroundRole()));
+
+    const QImage &blurred = m_backdrop.blurred(sourceRect.toAlignedRect());
+    painter->drawImage(QRectF(rect), blurred, sourceRect);
+    painter->fillRect(rect, m_backdropTint);
 }
@@ -4,28 +4,91 @@
 #include <QScreen>
 #include <QWidget>
 
+#include "backdropblur.h"
 #include "titlebar.h"
 
+class CornerOverlay;
+class QPainter;
+
+struct ChromeMemoryUsage
+{
+    qint64 titleBar = 0;
+    qint64 backdrop = 0;
+    // Reported only, estimated from the window size. Qt owns it and keeps
+    // it while the window is minimized or hidden.
+    qint64 backingStore = 0;
+
+    // What releaseResources() frees, except for the parsed button svgs.
+    qint64 releasable() const { return titleBar + backdrop; }
+    qint64 total() const { return releasable() + backingStore; }
+};
+
 class FramelessWidget : public QWidget
 {
     Q_OBJECT
 public:
-    explicit FramelessWidget(QWidget *parent = nullptr);
+    // A |cornerRadius| above 0 creates the window rounded, see
+    // setCornerRadius().
+    explicit FramelessWidget(QWidget *parent = nullptr, int cornerRadius = 0);
     virtual ~FramelessWidget();
     void setTitleBar(TitleBar *titleBar);
+    TitleBar *titleBar() const;
     void setResizeEnabled(bool enable);
 
+    // Rounds the window corners by |radius| logical pixels, 0 disables it.
+    // Corners are cut from shared antialiased pieces instead of a mask, also
+    // through the children, and are suppressed while the window is maximized
+    // or fullscreen. Rounded windows need a translucent native window, so
+    // switching rounding on or off only works before it is created, which
+    // happens in the constructor on Windows.
+    void setCornerRadius(int radius);
+    int cornerRadius() const;
+
+    // Paints a blurred, tinted slice of |image| behind the window. The image
+    // covers the virtual desktop, one device pixel per image pixel. Nothing
+    // is captured from behind the window, the application supplies the image
+    // and keeps it current with updateBackdropImage().
+    void setBackdropImage(const QImage &image);
+    void updateBackdropImage(const QImage &image, const QRect &dirtyRect);
+    void setBackdropBlurRadius(int radius);
+    void setBackdropTint(const QColor &tint);
+
+    // Caches are released while the window is minimized or hidden and
+    // rebuilt when it comes back.
+    ChromeMemoryUsage memoryUsage() const;
+    void releaseResources();
+    void restoreResources();
+
 protected:
+    virtual void paintEvent(QPaintEvent *event) override;
+    virtual void moveEvent(QMoveEvent *event) override;
     virtual void resizeEvent(QResizeEvent *event) override;
+    virtual void showEvent(QShowEvent *event) override;
+    virtual void hideEvent(QHideEvent *event) override;
     virtual bool nativeEvent(
         const QByteArray &eventType, void *message, long *result) override;
+    virtual void childEvent(QChildEvent *event) override;
 
 private slots:
     void onScreenChanged(QScreen *screen);
+    void onWindowStateChanged(Qt::WindowStates state);
+
+private:
+    bool hasRoundedCorners() const;
+    int effectiveCornerRadius(const QSize &size) const;
+    void updateCornerOverlays();
+    QScreen *screenAt(const QPoint &globalPos) const;
+    QPointF backdropPosition(const QPoint &globalPos) const;
+    QRegion backdropRegion() const;
+    void paintBackdrop(QPainter *painter, const QRect &rect);
 
 protected:
     TitleBar *m_titleBar;
     bool m_isResizeEnable;
+    int m_cornerRadius;
+    BackdropBlur m_backdrop;
+    QColor m_backdropTint;
+    CornerOverlay *m_cornerOverlays[4];
 };
 
 #endif  // FRAMELESSWIDGET_H
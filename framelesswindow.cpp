@@ -0,0 +1,343 @@
+#include "framelesswindow.h"
+
+#include <QCursor>
+#include <QExposeEvent>
+#include <QFile>
+#include <QFont>
+#include <QIcon>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QResizeEvent>
+#include <QScreen>
+#include <QtMath>
+
+#include "framelesshelper.h"
+#include "titlebarbutton.h"
+
+// Allocation policy of the backing store during a live resize.
+constexpr qreal kGrowthFactor = 1.5;
+constexpr int kTrimDelay = 300;
+
+FramelessWindow::FramelessWindow(QWindow *parent)
+    : QWindow(parent),
+      m_backingStore(new QBackingStore(this)),
+      m_trimTimer(new QTimer(this)),
+      m_allocations(0),
+      m_isResizeEnable(true),
+      m_backgroundColor(Qt::white),
+      m_hoveredButton(CaptionButton::kNone),
+      m_pressedButton(CaptionButton::kNone)
+{
+    if (isFramelessHintSupported())
+        setFlags(flags() | Qt::FramelessWindowHint);
+    else
+        setFlags(Qt::FramelessWindowHint | Qt::WindowMaximizeButtonHint);
+
+    resize(500, 500);
+
+    m_trimTimer->setSingleShot(true);
+    m_trimTimer->setInterval(kTrimDelay);
+    connect(
+        m_trimTimer, &QTimer::timeout, this,
+        &FramelessWindow::trimBackingStore);
+    connect(
+        this, &QWindow::windowStateChanged, this, &QWindow::requestUpdate);
+    connect(
+        this, &QWindow::windowTitleChanged, this, &QWindow::requestUpdate);
+    connect(
+        this, &QWindow::screenChanged, this,
+        &FramelessWindow::onScreenChanged);
+
+    QFile f(":/btn/res/close.svg");
+    f.open(QFile::ReadOnly);
+    m_closeSvgDom.setContent(f.readAll());
+    f.close();
+
+#ifdef Q_OS_WIN
+    setupFramelessWindow(this);
+#endif
+}
+
+FramelessWindow::~FramelessWindow()
+{
+    delete m_backingStore;
+}
+
+void FramelessWindow::setResizeEnabled(bool enable)
+{
+    m_isResizeEnable = enable;
+}
+
+void FramelessWindow::setBackgroundColor(const QColor &color)
+{
+    if (m_backgroundColor == color)
+        return;
+
+    m_backgroundColor = color;
+    requestUpdate();
+}
+
+int FramelessWindow::backingStoreAllocations() const
+{
+    return m_allocations;
+}
+
+void FramelessWindow::paint(QPainter *painter, const QRect &rect)
+{
+    Q_UNUSED(painter)
+    Q_UNUSED(rect)
+}
+
+bool FramelessWindow::event(QEvent *event)
+{
+    switch (event->type())
+    {
+        case QEvent::UpdateRequest:
+            render();
+            return true;
+        case QEvent::Leave:
+            setHoveredButton(CaptionButton::kNone);
+            break;
+        default:
+            break;
+    }
+    return QWindow::event(event);
+}
+
+void FramelessWindow::exposeEvent(QExposeEvent *event)
+{
+    Q_UNUSED(event)
+    render();
+}
+
+void FramelessWindow::resizeEvent(QResizeEvent *event)
+{
+    // The expose event that follows renders the new size.
+    reserveBackingStore(event->size());
+    // Shrink once the user stops resizing.
+    m_trimTimer->start();
+}
+
+void FramelessWindow::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() != Qt::LeftButton)
+        return;
+
+    m_pressedButton = captionButtonAt(event->pos(), width());
+    if (m_pressedButton != CaptionButton::kNone)
+    {
+        requestUpdate();
+        return;
+    }
+
+#ifndef Q_OS_WIN
+    // Windows resizes through WM_NCHITTEST instead.
+    const Qt::Edges edges = resizeEdgesAt(geometry(), event->globalPos());
+    if (m_isResizeEnable && edges &&
+        !(windowStates() & (Qt::WindowMaximized | Qt::WindowFullScreen)))
+    {
+        startSystemResize(edges);
+        return;
+    }
+#endif
+
+    if (isCaptionDragArea(event->pos(), width()))
+        startSystemMove();
+}
+
+void FramelessWindow::mouseMoveEvent(QMouseEvent *event)
+{
+    if (m_pressedButton != CaptionButton::kNone)
+        return;
+
+    setHoveredButton(captionButtonAt(event->pos(), width()));
+#ifndef Q_OS_WIN
+    if (m_isResizeEnable)
+    {
+        setCursor(
+            cursorForEdges(resizeEdgesAt(geometry(), event->globalPos())));
+    }
+#endif
+}
+
+void FramelessWindow::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (event->button() != Qt::LeftButton ||
+        m_pressedButton == CaptionButton::kNone)
+        return;
+
+    const CaptionButton button = m_pressedButton;
+    m_pressedButton = CaptionButton::kNone;
+    setHoveredButton(captionButtonAt(event->pos(), width()));
+    requestUpdate();
+    if (captionButtonAt(event->pos(), width()) != button)
+        return;
+
+    switch (button)
+    {
+        case CaptionButton::kMinimize:
+            showMinimized();
+            break;
+        case CaptionButton::kMaximize:
+            toggleMaxState();
+            break;
+        case CaptionButton::kClose:
+            close();
+            break;
+        default:
+            break;
+    }
+}
+
+void FramelessWindow::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    if (event->button() != Qt::LeftButton ||
+        !isCaptionDragArea(event->pos(), width()))
+        return;
+
+    toggleMaxState();
+}
+
+bool FramelessWindow::nativeEvent(
+    const QByteArray &eventType, void *message, long *result)
+{
+    if (handleFramelessNativeEvent(this, message, result, m_isResizeEnable))
+        return true;
+
+    return QWindow::nativeEvent(eventType, message, result);
+}
+
+void FramelessWindow::onScreenChanged(QScreen *screen)
+{
+    Q_UNUSED(screen)
+#ifdef Q_OS_WIN
+    updateWindowFrame(this);
+#endif
+}
+
+void FramelessWindow::trimBackingStore()
+{
+    if (m_backingStore->size() == size())
+        return;
+
+    m_backingStore->resize(size());
+    ++m_allocations;
+    requestUpdate();
+}
+
+void FramelessWindow::toggleMaxState()
+{
+    if (windowStates().testFlag(Qt::WindowMaximized))
+        showNormal();
+    else
+        showMaximized();
+}
+
+void FramelessWindow::render()
+{
+    if (!isExposed())
+        return;
+
+    const QRect rect(QPoint(0, 0), size());
+    reserveBackingStore(rect.size());
+    m_backingStore->beginPaint(rect);
+
+    QPainter painter(m_backingStore->paintDevice());
+    painter.fillRect(rect, m_backgroundColor);
+    paint(&painter, rect.adjusted(0, kTitleBarHeight, 0, 0));
+    paintTitleBar(&painter);
+    painter.end();
+
+    m_backingStore->endPaint();
+    m_backingStore->flush(rect);
+}
+
+void FramelessWindow::paintTitleBar(QPainter *painter)
+{
+    // same layout and palette as TitleBar
+    const QIcon icon = this->icon();
+    if (!icon.isNull())
+        painter->drawPixmap(10, 6, icon.pixmap(20, 20));
+
+    QFont font("Segoe UI");
+    font.setPixelSize(13);
+    painter->setFont(font);
+    painter->setPen(Qt::black);
+    const int titleX = 34;
+    painter->drawText(
+        QRect(
+            titleX, 0,
+            captionButtonRect(CaptionButton::kMinimize, width()).left() -
+                titleX,
+            kTitleBarHeight),
+        Qt::AlignLeft | Qt::AlignVCenter, title());
+
+    for (int i = 0; i < kCaptionButtonCount; ++i)
+    {
+        const CaptionButton button = static_cast<CaptionButton>(i);
+        TitleBarButtonState state = kNormal;
+        if (m_pressedButton == button)
+            state = kPressed;
+        else if (
+            m_pressedButton == CaptionButton::kNone &&
+            m_hoveredButton == button)
+            state = kHover;
+        const CaptionButtonColors colors = captionButtonColors(button, state);
+
+        const QRect rect = captionButtonRect(button, width());
+        painter->fillRect(rect, colors.background);
+        painter->save();
+        painter->translate(rect.topLeft());
+        switch (button)
+        {
+            case CaptionButton::kMinimize:
+                MinimizeButton::drawIcon(
+                    painter, colors.icon, devicePixelRatio());
+                break;
+            case CaptionButton::kMaximize:
+                MaximizeButton::drawIcon(
+                    painter, colors.icon,
+                    windowStates().testFlag(Qt::WindowMaximized),
+                    devicePixelRatio());
+                break;
+            default:
+                SvgTitleBarButton::drawIcon(
+                    painter, m_closeSvgDom, colors.icon,
+                    QRectF(0, 0, rect.width(), rect.height()));
+                break;
+        }
+        painter->restore();
+    }
+}
+
+void FramelessWindow::reserveBackingStore(const QSize &size)
+{
+    const QSize allocated = m_backingStore->size();
+    if (allocated.width() >= size.width() &&
+        allocated.height() >= size.height())
+        return;
+
+    // Grow geometrically so a live resize only reallocates a few times, the
+    // surplus is trimmed once resizing stops.
+    QSize grown = allocated.expandedTo(QSize(0, 0));
+    if (grown.width() < size.width())
+        grown.setWidth(
+            qMax(size.width(), qCeil(grown.width() * kGrowthFactor)));
+    if (grown.height() < size.height())
+        grown.setHeight(
+            qMax(size.height(), qCeil(grown.height() * kGrowthFactor)));
+    if (screen())
+        grown = grown.boundedTo(screen()->virtualSize()).expandedTo(size);
+
+    m_backingStore->resize(grown);
+    ++m_allocations;
+}
+
+void FramelessWindow::setHoveredButton(CaptionButton button)
+{
+    if (m_hoveredButton == button)
+        return;
+
+    m_hoveredButton = button;
+    requestUpdate();
+}
@@ -0,0 +1,63 @@
+#ifndef FRAMELESSWINDOW_H
+#define FRAMELESSWINDOW_H
+
+#include <QBackingStore>
+#include <QColor>
+#include <QDomDocument>
+#include <QTimer>
+#include <QWindow>
+
+#include "framelesshelper.h"
+
+// A lightweight frameless top level window without the QWidget machinery.
+// It owns its backing store and paints the same title bar as TitleBar.
+class FramelessWindow : public QWindow
+{
+    Q_OBJECT
+public:
+    explicit FramelessWindow(QWindow *parent = nullptr);
+    virtual ~FramelessWindow();
+
+    void setResizeEnabled(bool enable);
+    void setBackgroundColor(const QColor &color);
+
+    // Number of times the backing store was reallocated.
+    int backingStoreAllocations() const;
+
+protected:
+    // Paints the client area below the title bar.
+    virtual void paint(QPainter *painter, const QRect &rect);
+
+    virtual bool event(QEvent *event) override;
+    virtual void exposeEvent(QExposeEvent *event) override;
+    virtual void resizeEvent(QResizeEvent *event) override;
+    virtual void mousePressEvent(QMouseEvent *event) override;
+    virtual void mouseMoveEvent(QMouseEvent *event) override;
+    virtual void mouseReleaseEvent(QMouseEvent *event) override;
+    virtual void mouseDoubleClickEvent(QMouseEvent *event) override;
+    virtual bool nativeEvent(
+        const QByteArray &eventType, void *message, long *result) override;
+
+private slots:
+    void onScreenChanged(QScreen *screen);
+    void trimBackingStore();
+    void toggleMaxState();
+
+private:
+    void render();
+    void paintTitleBar(QPainter *painter);
+    void reserveBackingStore(const QSize &size);
+    void setHoveredButton(CaptionButton button);
+
+private:
+    QBackingStore *m_backingStore;
+    QTimer *m_trimTimer;
+    int m_allocations;
+    bool m_isResizeEnable;
+    QColor m_backgroundColor;
+    CaptionButton m_hoveredButton;
+    CaptionButton m_pressedButton;
+    QDomDocument m_closeSvgDom;
+};
+
+#endif  // FRAMELESSWINDOW_H
@@ -0,0 +1,245 @@
+#include "inputtrace.h"
+
+#include <QCoreApplication>
+#include <QFile>
+#include <QMouseEvent>
+#include <QResizeEvent>
+#include <QWindow>
+
+constexpr quint32 kTraceMagic = 0x46574954;  // "FWIT"
+constexpr quint16 kTraceVersion = 1;
+// type, delay and window states, the shortest record
+constexpr qint64 kMinEventSize = 4;
+
+QDataStream &operator<<(QDataStream &stream, const InputTraceEvent &event)
+{
+    stream << event.type << event.delay;
+    switch (event.type)
+    {
+        case InputTraceEvent::kResize:
+            stream << event.x << event.y;
+            break;
+        case InputTraceEvent::kWindowState:
+            stream << event.states;
+            break;
+        default:
+            stream << event.button << event.buttons << event.x << event.y;
+            break;
+    }
+    return stream;
+}
+
+QDataStream &operator>>(QDataStream &stream, InputTraceEvent &event)
+{
+    stream >> event.type >> event.delay;
+    switch (event.type)
+    {
+        case InputTraceEvent::kResize:
+            stream >> event.x >> event.y;
+            break;
+        case InputTraceEvent::kWindowState:
+            stream >> event.states;
+            break;
+        default:
+            stream >> event.button >> event.buttons >> event.x >> event.y;
+            break;
+    }
+    return stream;
+}
+
+InputTraceRecorder::InputTraceRecorder(QWidget *window, QObject *parent)
+    : QObject(parent),
+      m_initialSize(window->size()),
+      m_stream(&m_trace, QIODevice::WriteOnly),
+      m_lastEventTime(0),
+      m_eventCount(0)
+{
+    // Events are recorded where they enter the window, before they are
+    // dispatched to the title bar and its buttons.
+    window->winId();
+    window->windowHandle()->installEventFilter(this);
+    m_clock.start();
+}
+
+int InputTraceRecorder::eventCount() const
+{
+    return m_eventCount;
+}
+
+bool InputTraceRecorder::save(const QString &fileName) const
+{
+    QFile f(fileName);
+    if (!f.open(QFile::WriteOnly))
+        return false;
+
+    QDataStream stream(&f);
+    stream << kTraceMagic << kTraceVersion
+           << static_cast<qint16>(m_initialSize.width())
+           << static_cast<qint16>(m_initialSize.height())
+           << static_cast<quint32>(m_eventCount);
+    stream.writeRawData(m_trace.constData(), m_trace.size());
+    return stream.status() == QDataStream::Ok;
+}
+
+bool InputTraceRecorder::eventFilter(QObject *obj, QEvent *event)
+{
+    InputTraceEvent traceEvent;
+    switch (event->type())
+    {
+        case QEvent::MouseButtonPress:
+        case QEvent::MouseButtonRelease:
+        case QEvent::MouseButtonDblClick:
+        case QEvent::MouseMove:
+        {
+            QMouseEvent *mouseEvent = static_cast<QMouseEvent *>(event);
+            if (event->type() == QEvent::MouseButtonPress)
+                traceEvent.type = InputTraceEvent::kMousePress;
+            else if (event->type() == QEvent::MouseButtonRelease)
+                traceEvent.type = InputTraceEvent::kMouseRelease;
+            else if (event->type() == QEvent::MouseButtonDblClick)
+                traceEvent.type = InputTraceEvent::kMouseDoubleClick;
+            else
+                traceEvent.type = InputTraceEvent::kMouseMove;
+            traceEvent.button = static_cast<quint8>(mouseEvent->button());
+            traceEvent.buttons = static_cast<quint8>(mouseEvent->buttons());
+            traceEvent.x = static_cast<qint16>(mouseEvent->x());
+            traceEvent.y = static_cast<qint16>(mouseEvent->y());
+            break;
+        }
+        case QEvent::Resize:
+        {
+            QResizeEvent *resizeEvent = static_cast<QResizeEvent *>(event);
+            traceEvent.type = InputTraceEvent::kResize;
+            traceEvent.x = static_cast<qint16>(resizeEvent->size().width());
+            traceEvent.y = static_cast<qint16>(resizeEvent->size().height());
+            break;
+        }
+        case QEvent::WindowStateChange:
+            traceEvent.type = InputTraceEvent::kWindowState;
+            traceEvent.states = static_cast<quint8>(
+                static_cast<QWindow *>(obj)->windowStates());
+            break;
+        default:
+            return QObject::eventFilter(obj, event);
+    }
+
+    append(traceEvent);
+    return QObject::eventFilter(obj, event);
+}
+
+void InputTraceRecorder::append(const InputTraceEvent &traceEvent)
+{
+    InputTraceEvent event = traceEvent;
+    const qint64 now = m_clock.elapsed();
+    event.delay =
+        static_cast<quint16>(qMin<qint64>(now - m_lastEventTime, 0xffff));
+    m_lastEventTime = now;
+
+    m_stream << event;
+    ++m_eventCount;
+}
+
+bool InputTraceReplayer::load(const QString &fileName)
+{
+    QFile f(fileName);
+    if (!f.open(QFile::ReadOnly))
+        return false;
+
+    QDataStream stream(&f);
+    quint32 magic = 0;
+    quint16 version = 0;
+    qint16 width = 0;
+    qint16 height = 0;
+    quint32 count = 0;
+    stream >> magic >> version >> width >> height >> count;
+    if (magic != kTraceMagic || version != kTraceVersion)
+        return false;
+
+    m_initialSize = QSize(width, height);
+    m_events.clear();
+    // The count comes from the file, the records it claims have to fit in
+    // what is left of it.
+    m_events.reserve(static_cast<int>(
+        qMin<qint64>(count, (f.size() - f.pos()) / kMinEventSize)));
+    for (quint32 i = 0; i < count; ++i)
+    {
+        InputTraceEvent event;
+        stream >> event;
+        if (stream.status() != QDataStream::Ok ||
+            event.type < InputTraceEvent::kMousePress ||
+            event.type > InputTraceEvent::kWindowState)
+        {
+            m_events.clear();
+            return false;
+        }
+        m_events.append(event);
+    }
+    return true;
+}
+
+QSize InputTraceReplayer::initialSize() const
+{
+    return m_initialSize;
+}
+
+const QVector<InputTraceEvent> &InputTraceReplayer::events() const
+{
+    return m_events;
+}
+
+QVector<qint64> InputTraceReplayer::replay(QWidget *window) const
+{
+    QVector<qint64> nsecs;
+    nsecs.reserve(m_events.size());
+
+    window->resize(m_initialSize);
+    QCoreApplication::processEvents();
+
+    QElapsedTimer timer;
+    for (const InputTraceEvent &event : m_events)
+    {
+        timer.start();
+        dispatch(window, event);
+        QCoreApplication::processEvents();
+        nsecs.append(timer.nsecsElapsed());
+    }
+    return nsecs;
+}
+
+void InputTraceReplayer::dispatch(
+    QWidget *window, const InputTraceEvent &traceEvent) const
+{
+    QEvent::Type type = QEvent::None;
+    switch (traceEvent.type)
+    {
+        case InputTraceEvent::kMousePress:
+            type = QEvent::MouseButtonPress;
+            break;
+        case InputTraceEvent::kMouseRelease:
+            type = QEvent::MouseButtonRelease;
+            break;
+        case InputTraceEvent::kMouseDoubleClick:
+            type = QEvent::MouseButtonDblClick;
+            break;
+        case InputTraceEvent::kMouseMove:
+            type = QEvent::MouseMove;
+            break;
+        case InputTraceEvent::kResize:
+            window->resize(traceEvent.x, traceEvent.y);
+            return;
+        case InputTraceEvent::kWindowState:
+            window->setWindowState(Qt::WindowStates(QFlag(traceEvent.states)));
+            return;
+        default:
+            return;
+    }
+
+    // Sent to the QWindow like platform input, so the widgets below get the
+    // usual dispatching including enter and leave events.
+    const QPointF pos(traceEvent.x, traceEvent.y);
+    QMouseEvent event(
+        type, pos, pos, window->mapToGlobal(pos.toPoint()),
+        static_cast<Qt::MouseButton>(traceEvent.button),
+        Qt::MouseButtons(QFlag(traceEvent.buttons)), Qt::NoModifier);
+    QCoreApplication::sendEvent(window->windowHandle(), &event);
+}
@@ -0,0 +1,80 @@
+#ifndef INPUTTRACE_H
+#define INPUTTRACE_H
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QObject>
+#include <QSize>
+#include <QVector>
+#include <QWidget>
+
+// Compact binary trace of the mouse, resize and window state events that hit
+// a frameless window, in window coordinates.
+struct InputTraceEvent
+{
+    enum Type
+    {
+        kMousePress = 1,
+        kMouseRelease,
+        kMouseDoubleClick,
+        kMouseMove,
+        kResize,
+        kWindowState
+    };
+
+    quint8 type = 0;
+    // milliseconds since the previous event, informational only
+    quint16 delay = 0;
+    quint8 button = 0;
+    quint8 buttons = 0;
+    qint16 x = 0;
+    qint16 y = 0;
+    quint8 states = 0;
+};
+
+class InputTraceRecorder : public QObject
+{
+    Q_OBJECT
+public:
+    explicit InputTraceRecorder(QWidget *window, QObject *parent = nullptr);
+
+    int eventCount() const;
+    bool save(const QString &fileName) const;
+
+protected:
+    virtual bool eventFilter(QObject *obj, QEvent *event) override;
+
+private:
+    void append(const InputTraceEvent &traceEvent);
+
+private:
+    QSize m_initialSize;
+    QByteArray m_trace;
+    QDataStream m_stream;
+    QElapsedTimer m_clock;
+    qint64 m_lastEventTime;
+    int m_eventCount;
+};
+
+class InputTraceReplayer
+{
+public:
+    bool load(const QString &fileName);
+
+    QSize initialSize() const;
+    const QVector<InputTraceEvent> &events() const;
+
+    // Replays the trace as fast as possible, in order, and returns the time
+    // each event took including the work it caused.
+    QVector<qint64> replay(QWidget *window) const;
+
+private:
+    void dispatch(QWidget *window, const InputTraceEvent &traceEvent) const;
+
+private:
+    QSize m_initialSize;
+    QVector<InputTraceEvent> m_events;
+};
+
+#endif  // INPUTTRACE_H
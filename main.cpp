@@ -1,7 +1,19 @@
 #include <QApplication>
+#include <QCommandLineParser>
 #include <QIcon>
 
+#include "chromediagnostics.h"
+#include "chrometrace.h"
 #include "framelesswidget.h"
+#include "inputtrace.h"
+#include "sessionstate.h"
+
+#ifdef FRAMELESS_QUICK
+#include <QQmlApplicationEngine>
+#include <QQuickWindow>
+
+#include "framelessquickwindow.h"
+#endif
 
 int main(int argc, char *argv[])
 {
@@ -9,10 +21,168 @@ int main(int argc, char *argv[])
 //    QApplication::setAttribute(Qt::AA_UseHighDpiPixmaps);
     QApplication::setAttribute(Qt::AA_DontCreateNativeWidgetSiblings);
     QApplication a(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption memoryCheckOption(
+        "memory-check", "Creates <count> windows and reports their heap cost.",
+        "count");
+    QCommandLineOption budgetOption(
+        "budget", "Heap budget per window for --memory-check, 0 disables it.",
+        "bytes", QString::number(kDefaultWindowBudget));
+    QCommandLineOption lifecycleOption(
+        "lifecycle-benchmark",
+        "Times the lifecycle phases of a window over <runs> runs.", "runs");
+    QCommandLineOption resizeOption(
+        "resize-benchmark",
+        "Resizes a QWindow and a QWidget window <steps> times and compares.",
+        "steps");
+    QCommandLineOption blurOption(
+        "blur-benchmark",
+        "Blurs a 3840x2160 backdrop for <frames> frames and times it.",
+        "frames");
+    QCommandLineOption recordOption(
+        "record-trace", "Records the input of the demo window to <file>.",
+        "file");
+    QCommandLineOption replayOption(
+        "replay-trace", "Replays the input trace <file> and reports the work.",
+        "file");
+    QCommandLineOption maxPaintsOption(
+        "max-paints",
+        "Fails --replay-trace above <count> paints per event on average.",
+        "count", "-1");
+    QCommandLineOption stateStressOption(
+        "state-stress",
+        "Drives <count> random window state changes and reports the work.",
+        "count");
+    QCommandLineOption seedOption(
+        "seed", "Random seed for --state-stress.", "seed", "1");
+    QCommandLineOption maxRedundantOption(
+        "max-redundant",
+        "Fails --state-stress above <percent> redundant transitions.",
+        "percent", "-1");
+    QCommandLineOption restoreOption(
+        "restore-benchmark",
+        "Restores <count> windows from a session file and times it.", "count");
+    QCommandLineOption glyphCheckOption(
+        "glyph-check", "Checks the caption glyphs at several scales.");
+    QCommandLineOption tabsOption(
+        "tabs", "Opens <count> tabs in the title bar of the demo window.",
+        "count");
+    QCommandLineOption sessionOption(
+        "session", "Restores the demo window from <file> and saves it there.",
+        "file");
+    QCommandLineOption traceOption(
+        "trace",
+        "Traces chrome events, written to <file> on quit and on SIGUSR1.",
+        "file");
+    parser.addOption(memoryCheckOption);
+    parser.addOption(budgetOption);
+    parser.addOption(lifecycleOption);
+    parser.addOption(resizeOption);
+    parser.addOption(blurOption);
+    parser.addOption(recordOption);
+    parser.addOption(replayOption);
+    parser.addOption(maxPaintsOption);
+    parser.addOption(stateStressOption);
+    parser.addOption(seedOption);
+    parser.addOption(maxRedundantOption);
+    parser.addOption(restoreOption);
+    parser.addOption(glyphCheckOption);
+#ifdef FRAMELESS_QUICK
+    QCommandLineOption quickOption(
+        "quick", "Shows the QML variant of the demo window.");
+    QCommandLineOption softwareOption(
+        "software", "Renders --quick with the software scene graph.");
+    parser.addOption(quickOption);
+    parser.addOption(softwareOption);
+#endif
+    parser.addOption(tabsOption);
+    parser.addOption(sessionOption);
+    parser.addOption(traceOption);
+    parser.process(a);
+
+    if (parser.isSet(traceOption))
+    {
+        const QString fileName = parser.value(traceOption);
+        ChromeTrace::setEnabled(true);
+        ChromeTrace::dumpOnSignal(fileName);
+        QObject::connect(
+            &a, &QCoreApplication::aboutToQuit,
+            [fileName]() { ChromeTrace::dump(fileName); });
+    }
+
+    if (parser.isSet(memoryCheckOption))
+    {
+        return runMemoryBudgetCheck(
+            parser.value(memoryCheckOption).toInt(),
+            parser.value(budgetOption).toLongLong());
+    }
+    if (parser.isSet(lifecycleOption))
+        return runLifecycleBenchmark(parser.value(lifecycleOption).toInt());
+    if (parser.isSet(resizeOption))
+        return runResizeBenchmark(parser.value(resizeOption).toInt());
+    if (parser.isSet(blurOption))
+        return runBlurBenchmark(parser.value(blurOption).toInt());
+    if (parser.isSet(replayOption))
+    {
+        return runInputReplay(
+            parser.value(replayOption),
+            parser.value(maxPaintsOption).toDouble());
+    }
+    if (parser.isSet(glyphCheckOption))
+        return runGlyphCheck();
+    if (parser.isSet(restoreOption))
+        return runRestoreBenchmark(parser.value(restoreOption).toInt());
+    if (parser.isSet(stateStressOption))
+    {
+        return runStateStress(
+            parser.value(stateStressOption).toInt(),
+            parser.value(seedOption).toUInt(),
+            parser.value(maxRedundantOption).toDouble());
+    }
+
+#ifdef FRAMELESS_QUICK
+    if (parser.isSet(quickOption))
+    {
+        if (parser.isSet(softwareOption))
+            QQuickWindow::setSceneGraphBackend(QSGRendererInterface::Software);
+        registerFramelessQuickTypes();
+        QQmlApplicationEngine engine(QUrl("qrc:/qml/res/main.qml"));
+        if (engine.rootObjects().isEmpty())
+            return 1;
+        return a.exec();
+    }
+#endif
+
+    // the file outlives the window and the tracker that writes to it
+    SessionStateFile sessionFile;
     FramelessWidget w;
     w.setWindowTitle("Frameless Window");
     w.setWindowIcon(QIcon(":/logo/logo.png"));
     w.setStyleSheet("background:white");
+    const int tabCount = parser.value(tabsOption).toInt();
+    for (int i = 0; i < tabCount; ++i)
+        w.titleBar()->tabStrip()->addTab(QString("Tab %1").arg(i + 1));
+    SessionTracker sessionTracker(&sessionFile);
+    if (parser.isSet(sessionOption))
+    {
+        const QString fileName = parser.value(sessionOption);
+        if (sessionFile.open(fileName) && sessionFile.count() > 0)
+            applySessionWindowState(&w, sessionFile.state(0));
+        else
+            sessionFile.write(fileName, {sessionWindowState(&w)});
+        sessionTracker.track(&w, 0);
+    }
     w.show();
+
+    if (parser.isSet(recordOption))
+    {
+        InputTraceRecorder *recorder = new InputTraceRecorder(&w, &w);
+        const QString fileName = parser.value(recordOption);
+        QObject::connect(
+            &a, &QCoreApplication::aboutToQuit,
+            [recorder, fileName]() { recorder->save(fileName); });
+    }
     return a.exec();
 }
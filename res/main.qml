@@ -0,0 +1,41 @@
+import QtQuick 2.12
+import FramelessWindow 1.0
+
+FramelessWindow {
+    id: window
+    width: 500
+    height: 500
+    visible: true
+    title: "Frameless Quick Window"
+
+    Item {
+        id: titleBar
+        anchors.left: parent.left
+        anchors.right: parent.right
+        height: window.titleBarHeight
+
+        Image {
+            x: 10
+            anchors.verticalCenter: parent.verticalCenter
+            width: 20
+            height: 20
+            source: "qrc:/logo/logo.png"
+        }
+
+        Text {
+            x: 34
+            anchors.verticalCenter: parent.verticalCenter
+            text: window.title
+            font.family: "Segoe UI"
+            font.pixelSize: 13
+        }
+
+        Row {
+            anchors.right: parent.right
+
+            TitleBarButton { role: TitleBarButton.Minimize }
+            TitleBarButton { role: TitleBarButton.Maximize }
+            TitleBarButton { role: TitleBarButton.Close }
+        }
+    }
+}
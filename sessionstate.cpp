@@ -0,0 +1,392 @@
+#include "sessionstate.h"
+
+#include <climits>
+#include <cstring>
+
+#include <QEvent>
+#include <QGuiApplication>
+#include <QScreen>
+#include <QWindow>
+
+constexpr quint32 kSessionMagic = 0x46575353;  // "FWSS"
+constexpr quint32 kSessionVersion = 1;
+// Records reserved on top of the written ones for appending windows.
+constexpr int kSpareRecords = 16;
+constexpr int kFlushDelay = 500;
+
+struct SessionFileHeader
+{
+    quint32 magic;
+    quint32 version;
+    quint32 recordSize;
+    quint32 recordCount;
+    quint32 recordCapacity;
+    // bytes used in the string table
+    quint32 stringsSize;
+};
+
+// Strings are UTF-16, offsets are in bytes from the start of the string
+// table and lengths and capacities in characters.
+struct SessionFileRecord
+{
+    qint32 x;
+    qint32 y;
+    qint32 width;
+    qint32 height;
+    quint32 states;
+    quint32 screenOffset;
+    quint32 screenLength;
+    quint32 screenCapacity;
+    quint32 titleOffset;
+    quint32 titleLength;
+    quint32 titleCapacity;
+};
+
+static qint64 recordOffset(quint32 index)
+{
+    return sizeof(SessionFileHeader) +
+           qint64(index) * sizeof(SessionFileRecord);
+}
+
+SessionWindowState sessionWindowState(const QWidget *window)
+{
+    SessionWindowState state;
+    state.states = window->windowState();
+    if (state.states & (Qt::WindowMaximized | Qt::WindowFullScreen))
+        state.geometry = window->normalGeometry();
+    else
+        state.geometry = window->geometry();
+    if (window->windowHandle() && window->windowHandle()->screen())
+        state.screenName = window->windowHandle()->screen()->name();
+    state.title = window->windowTitle();
+    return state;
+}
+
+void applySessionWindowState(QWidget *window, const SessionWindowState &state)
+{
+    QScreen *screen = nullptr;
+    for (QScreen *s : QGuiApplication::screens())
+    {
+        if (s->name() == state.screenName)
+        {
+            screen = s;
+            break;
+        }
+    }
+
+    QRect geometry = state.geometry;
+    if (!screen)
+        screen = QGuiApplication::primaryScreen();
+    if (screen && !screen->availableGeometry().intersects(geometry))
+    {
+        const QRect available = screen->availableGeometry();
+        geometry.setSize(geometry.size().boundedTo(available.size()));
+        geometry.moveCenter(available.center());
+    }
+
+    window->setWindowTitle(state.title);
+    if (geometry.isValid())
+        window->setGeometry(geometry);
+    // Minimized windows come back normal.
+    window->setWindowState(state.states & ~Qt::WindowMinimized);
+}
+
+SessionStateFile::SessionStateFile() : m_data(nullptr), m_size(0) {}
+
+SessionStateFile::~SessionStateFile()
+{
+    close();
+}
+
+bool SessionStateFile::open(const QString &fileName)
+{
+    close();
+    m_file.setFileName(fileName);
+    if (!m_file.open(QFile::ReadWrite) || !map())
+    {
+        close();
+        return false;
+    }
+
+    SessionFileHeader header;
+    std::memcpy(&header, m_data, sizeof(header));
+    // count() and the indexes are ints, the sizes are checked in 64 bits so
+    // a corrupt header can't wrap around into the mapping.
+    if (header.magic != kSessionMagic || header.version != kSessionVersion ||
+        header.recordSize != sizeof(SessionFileRecord) ||
+        header.recordCapacity > quint32(INT_MAX) ||
+        header.recordCount > header.recordCapacity ||
+        recordOffset(header.recordCapacity) > m_size ||
+        recordOffset(header.recordCapacity) + qint64(header.stringsSize) >
+            m_size)
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void SessionStateFile::close()
+{
+    unmap();
+    m_file.close();
+}
+
+bool SessionStateFile::isOpen() const
+{
+    return m_data != nullptr;
+}
+
+int SessionStateFile::count() const
+{
+    if (!m_data)
+        return 0;
+
+    SessionFileHeader header;
+    std::memcpy(&header, m_data, sizeof(header));
+    return header.recordCount;
+}
+
+SessionWindowState SessionStateFile::state(int index) const
+{
+    SessionWindowState state;
+    if (index < 0 || index >= count())
+        return state;
+
+    SessionFileHeader header;
+    std::memcpy(&header, m_data, sizeof(header));
+    SessionFileRecord record;
+    std::memcpy(&record, m_data + recordOffset(index), sizeof(record));
+
+    const uchar *strings = m_data + recordOffset(header.recordCapacity);
+    auto readString = [&](quint32 offset, quint32 length) {
+        if (qint64(offset) + qint64(length) * 2 > header.stringsSize)
+            return QString();
+        return QString(
+            reinterpret_cast<const QChar *>(strings + offset), length);
+    };
+
+    state.geometry = QRect(record.x, record.y, record.width, record.height);
+    state.states = Qt::WindowStates(QFlag(record.states));
+    state.screenName = readString(record.screenOffset, record.screenLength);
+    state.title = readString(record.titleOffset, record.titleLength);
+    return state;
+}
+
+bool SessionStateFile::write(
+    const QString &fileName, const QVector<SessionWindowState> &states)
+{
+    close();
+
+    SessionFileHeader header;
+    header.magic = kSessionMagic;
+    header.version = kSessionVersion;
+    header.recordSize = sizeof(SessionFileRecord);
+    header.recordCount = states.size();
+    header.recordCapacity = states.size() + kSpareRecords;
+    header.stringsSize = 0;
+
+    QVector<SessionFileRecord> records(header.recordCapacity);
+    std::memset(records.data(), 0, records.size() * sizeof(SessionFileRecord));
+    QByteArray strings;
+    auto addString = [&strings](const QString &str, quint32 &offset,
+                                quint32 &length, quint32 &capacity) {
+        offset = strings.size();
+        length = capacity = str.size();
+        strings.append(
+            reinterpret_cast<const char *>(str.constData()), str.size() * 2);
+    };
+    for (int i = 0; i < states.size(); ++i)
+    {
+        const SessionWindowState &state = states.at(i);
+        SessionFileRecord &record = records[i];
+        record.x = state.geometry.x();
+        record.y = state.geometry.y();
+        record.width = state.geometry.width();
+        record.height = state.geometry.height();
+        record.states = static_cast<quint32>(state.states);
+        addString(
+            state.screenName, record.screenOffset, record.screenLength,
+            record.screenCapacity);
+        addString(
+            state.title, record.titleOffset, record.titleLength,
+            record.titleCapacity);
+    }
+    header.stringsSize = strings.size();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QFile::ReadWrite | QFile::Truncate))
+        return false;
+
+    const qint64 headerSize = sizeof(header);
+    const qint64 recordsSize = records.size() * sizeof(SessionFileRecord);
+    if (m_file.write(reinterpret_cast<const char *>(&header), headerSize) !=
+            headerSize ||
+        m_file.write(
+            reinterpret_cast<const char *>(records.constData()),
+            recordsSize) != recordsSize ||
+        m_file.write(strings) != strings.size() || !m_file.flush() || !map())
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool SessionStateFile::update(int index, const SessionWindowState &state)
+{
+    if (!m_data || index < 0 || index > count())
+        return false;
+
+    SessionFileHeader header;
+    std::memcpy(&header, m_data, sizeof(header));
+    if (index == int(header.recordCount))
+    {
+        if (header.recordCount == header.recordCapacity)
+        {
+            QVector<SessionWindowState> states;
+            states.reserve(header.recordCount + 1);
+            for (int i = 0; i < count(); ++i)
+                states.append(this->state(i));
+            states.append(state);
+            return write(m_file.fileName(), states);
+        }
+
+        SessionFileRecord empty;
+        std::memset(&empty, 0, sizeof(empty));
+        std::memcpy(m_data + recordOffset(index), &empty, sizeof(empty));
+        ++header.recordCount;
+        std::memcpy(m_data, &header, sizeof(header));
+    }
+
+    SessionFileRecord record;
+    std::memcpy(&record, m_data + recordOffset(index), sizeof(record));
+    record.x = state.geometry.x();
+    record.y = state.geometry.y();
+    record.width = state.geometry.width();
+    record.height = state.geometry.height();
+    record.states = static_cast<quint32>(state.states);
+
+    auto storeString = [this](const QString &str, quint32 &offset,
+                              quint32 &length, quint32 &capacity) {
+        SessionFileHeader header;
+        std::memcpy(&header, m_data, sizeof(header));
+        // a slot outside the string table is replaced like a small one
+        if (quint32(str.size()) > capacity ||
+            qint64(offset) + qint64(capacity) * 2 > header.stringsSize)
+        {
+            offset = appendString(str);
+            if (offset == quint32(-1))
+                return false;
+            capacity = str.size();
+        }
+        else
+        {
+            std::memcpy(
+                m_data + recordOffset(header.recordCapacity) + offset,
+                str.constData(), str.size() * 2);
+        }
+        length = str.size();
+        return true;
+    };
+    if (!storeString(
+            state.screenName, record.screenOffset, record.screenLength,
+            record.screenCapacity) ||
+        !storeString(
+            state.title, record.titleOffset, record.titleLength,
+            record.titleCapacity))
+        return false;
+
+    std::memcpy(m_data + recordOffset(index), &record, sizeof(record));
+    return true;
+}
+
+bool SessionStateFile::map()
+{
+    m_size = m_file.size();
+    if (m_size < qint64(sizeof(SessionFileHeader)))
+        return false;
+
+    m_data = m_file.map(0, m_size);
+    return m_data != nullptr;
+}
+
+void SessionStateFile::unmap()
+{
+    if (m_data)
+        m_file.unmap(m_data);
+    m_data = nullptr;
+    m_size = 0;
+}
+
+quint32 SessionStateFile::appendString(const QString &str)
+{
+    // The old slot is left unused until the next write().
+    SessionFileHeader header;
+    std::memcpy(&header, m_data, sizeof(header));
+    const quint32 offset = header.stringsSize;
+    const qint64 size = recordOffset(header.recordCapacity) + offset +
+                        qint64(str.size()) * 2;
+
+    unmap();
+    if (!m_file.resize(size) || !map())
+        return quint32(-1);
+
+    std::memcpy(
+        m_data + recordOffset(header.recordCapacity) + offset, str.constData(),
+        str.size() * 2);
+    header.stringsSize += str.size() * 2;
+    std::memcpy(m_data, &header, sizeof(header));
+    return offset;
+}
+
+SessionTracker::SessionTracker(SessionStateFile *file, QObject *parent)
+    : QObject(parent), m_file(file), m_flushTimer(new QTimer(this))
+{
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(kFlushDelay);
+    connect(m_flushTimer, &QTimer::timeout, this, &SessionTracker::flush);
+    // the windows may still move while the application shuts down
+    connect(
+        qApp, &QCoreApplication::aboutToQuit, this, &SessionTracker::flush);
+}
+
+SessionTracker::~SessionTracker()
+{
+    flush();
+}
+
+void SessionTracker::track(QWidget *window, int index)
+{
+    m_indexes.insert(window, index);
+    window->installEventFilter(this);
+    connect(window, &QObject::destroyed, this, [this, window]() {
+        m_indexes.remove(window);
+        m_dirty.remove(window);
+    });
+}
+
+void SessionTracker::flush()
+{
+    m_flushTimer->stop();
+    for (QWidget *window : m_dirty)
+        m_file->update(m_indexes.value(window), sessionWindowState(window));
+    m_dirty.clear();
+}
+
+bool SessionTracker::eventFilter(QObject *obj, QEvent *event)
+{
+    switch (event->type())
+    {
+        case QEvent::Move:
+        case QEvent::Resize:
+        case QEvent::WindowStateChange:
+        case QEvent::WindowTitleChange:
+            m_dirty.insert(static_cast<QWidget *>(obj));
+            m_flushTimer->start();
+            break;
+        default:
+            break;
+    }
+    return QObject::eventFilter(obj, event);
+}
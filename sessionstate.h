@@ -0,0 +1,90 @@
+#ifndef SESSIONSTATE_H
+#define SESSIONSTATE_H
+
+#include <QFile>
+#include <QHash>
+#include <QObject>
+#include <QRect>
+#include <QSet>
+#include <QString>
+#include <QTimer>
+#include <QVector>
+#include <QWidget>
+
+struct SessionWindowState
+{
+    // normal geometry, also for maximized and fullscreen windows
+    QRect geometry;
+    Qt::WindowStates states;
+    QString screenName;
+    QString title;
+};
+
+// Returns the state of |window| worth restoring.
+SessionWindowState sessionWindowState(const QWidget *window);
+// Applies |state| to a window that wasn't shown yet, so showing it lays it
+// out once at its final geometry. Windows of a screen that is gone are moved
+// to the primary screen.
+void applySessionWindowState(QWidget *window, const SessionWindowState &state);
+
+// Versioned binary file with one fixed size record per window followed by a
+// string table. It is memory mapped, records are read in place and updated
+// one at a time without rewriting the file.
+class SessionStateFile
+{
+public:
+    SessionStateFile();
+    ~SessionStateFile();
+
+    // Maps an existing file, fails on a foreign or older format.
+    bool open(const QString &fileName);
+    void close();
+    bool isOpen() const;
+
+    int count() const;
+    SessionWindowState state(int index) const;
+
+    // Rewrites the file compactly and keeps it mapped.
+    bool write(
+        const QString &fileName, const QVector<SessionWindowState> &states);
+    // Updates one record in place. Strings only move when they outgrow their
+    // slot and |index| == count() appends while there is spare capacity.
+    bool update(int index, const SessionWindowState &state);
+
+private:
+    bool map();
+    void unmap();
+    quint32 appendString(const QString &str);
+
+private:
+    QFile m_file;
+    uchar *m_data;
+    qint64 m_size;
+};
+
+// Writes the records of tracked windows back to the file shortly after they
+// move, resize, change state or title. Pending changes are also written on
+// aboutToQuit and on destruction, so |file| has to outlive the tracker.
+class SessionTracker : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SessionTracker(SessionStateFile *file, QObject *parent = nullptr);
+    virtual ~SessionTracker();
+
+    void track(QWidget *window, int index);
+
+public slots:
+    void flush();
+
+protected:
+    virtual bool eventFilter(QObject *obj, QEvent *event) override;
+
+private:
+    SessionStateFile *m_file;
+    QTimer *m_flushTimer;
+    QHash<QWidget *, int> m_indexes;
+    QSet<QWidget *> m_dirty;
+};
+
+#endif  // SESSIONSTATE_H
@@ -0,0 +1,104 @@
+#include "snapshottransition.h"
+
+#include <QPainter>
+#include <QScreen>
+#include <QTimer>
+#include <QVariantAnimation>
+#include <QWindow>
+
+#include "framelesshelper.h"
+
+constexpr int kTransitionDuration = 150;
+
+SnapshotTransition *SnapshotTransition::start(QWidget *window, bool maximize)
+{
+    // Hiding the window behind the overlay needs window opacity.
+    if (!window->isVisible() || !window->windowHandle() ||
+        !isCompositingSupported())
+        return nullptr;
+
+    QScreen *screen = window->windowHandle()->screen();
+    if (!screen)
+        return nullptr;
+
+    const QRect startGeometry = window->geometry();
+    const QRect endGeometry =
+        maximize ? screen->availableGeometry() : window->normalGeometry();
+    if (startGeometry == endGeometry || endGeometry.isEmpty())
+        return nullptr;
+
+    // Resizing a native window reallocates its backing store, so the
+    // overlay gets its size once and the animation only repaints it.
+    const QRect overlayGeometry = startGeometry.united(endGeometry);
+    SnapshotTransition *transition =
+        new SnapshotTransition(window, window->grab(), maximize);
+    transition->setGeometry(overlayGeometry);
+    transition->m_snapshotRect =
+        startGeometry.translated(-overlayGeometry.topLeft());
+    transition->show();
+    // Keep the window mapped so its state is untouched, just invisible.
+    window->setWindowOpacity(0.0);
+
+    QVariantAnimation *animation = new QVariantAnimation(transition);
+    animation->setDuration(kTransitionDuration);
+    animation->setEasingCurve(QEasingCurve::OutCubic);
+    animation->setStartValue(transition->m_snapshotRect);
+    animation->setEndValue(endGeometry.translated(-overlayGeometry.topLeft()));
+    connect(
+        animation, &QVariantAnimation::valueChanged, transition,
+        &SnapshotTransition::setSnapshotGeometry);
+    connect(
+        animation, &QVariantAnimation::finished, transition,
+        &SnapshotTransition::finish);
+    animation->start();
+    return transition;
+}
+
+SnapshotTransition::SnapshotTransition(
+    QWidget *window, const QPixmap &snapshot, bool maximize)
+    : QWidget(
+          nullptr,
+          Qt::Tool | Qt::FramelessWindowHint | Qt::WindowStaysOnTopHint),
+      m_window(window),
+      m_snapshot(snapshot),
+      m_maximize(maximize)
+{
+    setAttribute(Qt::WA_TranslucentBackground);
+    setAttribute(Qt::WA_ShowWithoutActivating);
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+}
+
+void SnapshotTransition::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event)
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.drawPixmap(m_snapshotRect, m_snapshot);
+}
+
+void SnapshotTransition::setSnapshotGeometry(const QVariant &geometry)
+{
+    const QRect rect = geometry.toRect();
+    if (m_snapshotRect == rect)
+        return;
+
+    // the old rect has to be cleared to transparent as well
+    update(m_snapshotRect.united(rect));
+    m_snapshotRect = rect;
+}
+
+void SnapshotTransition::finish()
+{
+    if (m_window)
+    {
+        // the only real relayout of the transition
+        if (m_maximize)
+            m_window->showMaximized();
+        else
+            m_window->showNormal();
+        m_window->setWindowOpacity(1.0);
+    }
+
+    // Give the window a chance to paint before the snapshot disappears.
+    QTimer::singleShot(0, this, &QObject::deleteLater);
+}
@@ -0,0 +1,38 @@
+#ifndef SNAPSHOTTRANSITION_H
+#define SNAPSHOTTRANSITION_H
+
+#include <QPixmap>
+#include <QPointer>
+#include <QWidget>
+
+// Animates a window between its normal and maximized geometry using a
+// snapshot of its content. The overlay covers both geometries and keeps its
+// size, only the snapshot is scaled in it during the animation and the
+// window itself is laid out once at the final size.
+class SnapshotTransition : public QWidget
+{
+    Q_OBJECT
+public:
+    // Returns nullptr when the window can't be animated, e.g. without a
+    // compositor, the caller should then change the state directly.
+    static SnapshotTransition *start(QWidget *window, bool maximize);
+
+protected:
+    virtual void paintEvent(QPaintEvent *event) override;
+
+private:
+    SnapshotTransition(QWidget *window, const QPixmap &snapshot, bool maximize);
+
+private slots:
+    void setSnapshotGeometry(const QVariant &geometry);
+    void finish();
+
+private:
+    QPointer<QWidget> m_window;
+    QPixmap m_snapshot;
+    // in overlay coordinates
+    QRect m_snapshotRect;
+    bool m_maximize;
+};
+
+#endif  // SNAPSHOTTRANSITION_H
@@ -4,6 +4,7 @@
 #include <Windows.h>
 #endif
 
+#include <QChildEvent>
 #include <QDebug>
 #include <QEvent>
 #include <QHBoxLayout>
@@ -11,36 +12,48 @@
 #include <QMouseEvent>
 #include <QPoint>
 
+#include "chromecounters.h"
+#include "chrometrace.h"
+#include "framelesshelper.h"
+
+// Only there to trace how long laying out the title bar takes.
+class TitleBarLayout : public QHBoxLayout
+{
+public:
+    explicit TitleBarLayout(QWidget *parent) : QHBoxLayout(parent) {}
+
+    virtual void setGeometry(const QRect &rect) override
+    {
+        CHROME_TRACE_SCOPE("TitleBar::layout");
+        QHBoxLayout::setGeometry(rect);
+    }
+};
+
 TitleBar::TitleBar(QWidget *parent)
     : QWidget(parent),
       m_isDoubleClickedEnabled(true),
+      m_isMaxTransitionEnabled(false),
       m_iconLabel(new QLabel(this)),
-      m_titleLabel(new QLabel(this))
+      m_titleLabel(new QLabel(this)),
+      m_tabStrip(nullptr)
 {
     m_maxBtn = new MaximizeButton(this);
     m_minBtn = new MinimizeButton(this);
     m_closeBtn = new CloseButton(":/btn/res/close.svg", this);
-    QHBoxLayout *hBoxLayout = new QHBoxLayout(this);
-    resize(200, 32);
-    setFixedHeight(32);
-
-    hBoxLayout->setSpacing(0);
-    hBoxLayout->setContentsMargins(0, 0, 0, 0);
-    hBoxLayout->setAlignment(Qt::AlignVCenter | Qt::AlignLeft);
-    hBoxLayout->addStretch(1);
-    hBoxLayout->addWidget(m_minBtn, 0, Qt::AlignRight);
-    hBoxLayout->addWidget(m_maxBtn, 0, Qt::AlignRight);
-    hBoxLayout->addWidget(m_closeBtn, 0, Qt::AlignRight);
-
-    m_minBtn->setHoverColor(Qt::white);
-    m_minBtn->setHoverBgColor(QColor(0, 100, 182));
-    m_minBtn->setPressedColor(Qt::white);
-    m_minBtn->setPressedBgColor(QColor(54, 57, 65));
-
-    m_maxBtn->setHoverColor(Qt::white);
-    m_maxBtn->setHoverBgColor(QColor(0, 100, 182));
-    m_maxBtn->setPressedColor(Qt::white);
-    m_maxBtn->setPressedBgColor(QColor(54, 57, 65));
+    m_layout = new TitleBarLayout(this);
+    resize(200, kTitleBarHeight);
+    setFixedHeight(kTitleBarHeight);
+
+    m_layout->setSpacing(0);
+    m_layout->setContentsMargins(0, 0, 0, 0);
+    m_layout->setAlignment(Qt::AlignVCenter | Qt::AlignLeft);
+    m_layout->addStretch(1);
+    m_layout->addWidget(m_minBtn, 0, Qt::AlignRight);
+    m_layout->addWidget(m_maxBtn, 0, Qt::AlignRight);
+    m_layout->addWidget(m_closeBtn, 0, Qt::AlignRight);
+
+    m_minBtn->setCaptionColors(CaptionButton::kMinimize);
+    m_maxBtn->setCaptionColors(CaptionButton::kMaximize);
 
     connect(
         m_minBtn, &QAbstractButton::clicked, window(), &QWidget::showMinimized);
@@ -52,10 +65,23 @@ TitleBar::TitleBar(QWidget *parent)
 
     // add window icon
     m_iconLabel->setFixedSize(20, 20);
-    hBoxLayout->insertSpacing(0, 10);
-    hBoxLayout->insertWidget(1, m_iconLabel, 0, Qt::AlignLeft);
+    m_layout->insertSpacing(0, 10);
+    m_layout->insertWidget(1, m_iconLabel, 0, Qt::AlignLeft);
     // add title label
-    hBoxLayout->insertWidget(2, m_titleLabel, 0, Qt::AlignLeft);
+    m_layout->insertWidget(2, m_titleLabel, 0, Qt::AlignLeft);
+    // custom widget slots, the center one sits between two stretches
+    m_leftLayout = createSlotLayout();
+    m_centerLayout = createSlotLayout();
+    m_rightLayout = createSlotLayout();
+    m_layout->insertLayout(3, m_leftLayout);
+    m_layout->insertLayout(5, m_centerLayout);
+    m_layout->insertStretch(6, 1);
+    m_layout->insertLayout(7, m_rightLayout);
+
+    trackInteractiveWidget(m_minBtn);
+    trackInteractiveWidget(m_maxBtn);
+    trackInteractiveWidget(m_closeBtn);
+
     m_titleLabel->setStyleSheet(
         "QLabel{background: transparent;font: 13px 'Segoe UI';padding: 0 4px}");
     connect(window(), &QWidget::windowIconChanged, this, &TitleBar::setIcon);
@@ -67,6 +93,65 @@ void TitleBar::setDoubleClickEnabled(bool enable)
     m_isDoubleClickedEnabled = enable;
 }
 
+void TitleBar::setMaxTransitionEnabled(bool enable)
+{
+    m_isMaxTransitionEnabled = enable;
+}
+
+TitleBarTabStrip *TitleBar::tabStrip()
+{
+    if (!m_tabStrip)
+    {
+        // Sits between the left slot and the stretch, the space it doesn't
+        // need stays caption.
+        m_tabStrip = new TitleBarTabStrip(this);
+        m_layout->insertWidget(m_layout->indexOf(m_leftLayout) + 1, m_tabStrip);
+        trackInteractiveWidget(m_tabStrip);
+        connect(
+            m_tabStrip, &TitleBarTabStrip::interactiveRegionChanged, this,
+            [this]() { updateInteractiveRegion(m_tabStrip); });
+    }
+    return m_tabStrip;
+}
+
+void TitleBar::addWidget(QWidget *widget, WidgetSlot slot)
+{
+    if (!widget || m_interactiveWidgets.contains(widget))
+        return;
+
+    switch (slot)
+    {
+        case kLeftSlot:
+            m_leftLayout->addWidget(widget);
+            break;
+        case kCenterSlot:
+            m_centerLayout->addWidget(widget);
+            break;
+        case kRightSlot:
+            m_rightLayout->addWidget(widget);
+            break;
+    }
+    trackInteractiveWidget(widget);
+}
+
+void TitleBar::removeWidget(QWidget *widget)
+{
+    if (!widget || !m_interactiveWidgets.contains(widget) ||
+        widget == m_tabStrip || qobject_cast<TitleBarButton *>(widget))
+        return;
+
+    untrackInteractiveWidget(widget);
+    m_leftLayout->removeWidget(widget);
+    m_centerLayout->removeWidget(widget);
+    m_rightLayout->removeWidget(widget);
+    widget->hide();
+}
+
+QRegion TitleBar::interactiveRegion() const
+{
+    return m_interactiveRegion;
+}
+
 void TitleBar::setTitle(const QString &title)
 {
     m_titleLabel->setText(title);
@@ -75,25 +160,67 @@ void TitleBar::setTitle(const QString &title)
 
 void TitleBar::setIcon(const QIcon &icon)
 {
+    m_icon = icon;
     m_iconLabel->setPixmap(icon.pixmap(20, 20));
 }
 
+void TitleBar::releaseResources()
+{
+    m_iconLabel->clear();
+    QList<TitleBarButton *> btns = findChildren<TitleBarButton *>();
+    for (auto btn : btns)
+        btn->releaseResources();
+}
+
+void TitleBar::restoreResources()
+{
+    if (m_iconLabel->pixmap(Qt::ReturnByValue).isNull() && !m_icon.isNull())
+        m_iconLabel->setPixmap(m_icon.pixmap(20, 20));
+}
+
+qint64 TitleBar::memoryUsage() const
+{
+    qint64 bytes = 0;
+    const QPixmap pixmap = m_iconLabel->pixmap(Qt::ReturnByValue);
+    if (!pixmap.isNull())
+        bytes += qint64(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+    return bytes;
+}
+
 bool TitleBar::eventFilter(QObject *obj, QEvent *event)
 {
+    if (event->type() == QEvent::Move || event->type() == QEvent::Resize ||
+        event->type() == QEvent::Show || event->type() == QEvent::Hide)
+    {
+        QWidget *widget = static_cast<QWidget *>(obj);
+        if (obj != window() && m_interactiveWidgets.contains(widget))
+            updateInteractiveRegion(widget);
+    }
+
     if (obj == window())
     {
         if (event->type() == QEvent::WindowStateChange)
         {
             m_maxBtn->setMaxState(window()->isMaximized());
+            emit windowStateChanged(window()->windowState());
             return false;
         }
     }
     return QWidget::eventFilter(obj, event);
 }
 
+void TitleBar::childEvent(QChildEvent *event)
+{
+    // Deleted or reparented, the child may be partially destroyed here.
+    if (event->removed())
+        untrackInteractiveWidget(event->child());
+    QWidget::childEvent(event);
+}
+
 void TitleBar::mouseDoubleClickEvent(QMouseEvent *event)
 {
-    if (event->button() != Qt::LeftButton || !m_isDoubleClickedEnabled)
+    if (event->button() != Qt::LeftButton || !m_isDoubleClickedEnabled ||
+        !isDragRegion(event->pos()))
         return;
 
     toggleMaxState();
@@ -122,6 +249,17 @@ void TitleBar::mousePressEvent(QMouseEvent *event)
 
 void TitleBar::toggleMaxState()
 {
+    if (m_maxTransition)
+        return;
+
+    if (m_isMaxTransitionEnabled && !window()->isFullScreen())
+    {
+        m_maxTransition =
+            SnapshotTransition::start(window(), !window()->isMaximized());
+        if (m_maxTransition)
+            return;
+    }
+
     if (window()->isMaximized())
         window()->showNormal();
     else
@@ -130,15 +268,74 @@ void TitleBar::toggleMaxState()
 
 bool TitleBar::isDragRegion(const QPoint &pos)
 {
-    int width = 0;
-    QList<TitleBarButton *> btns = findChildren<TitleBarButton *>();
-    for (auto btn : btns)
+    ChromeCounters::add(ChromeCounters::kHitTest);
+    return 0 < pos.x() && !m_interactiveRegion.contains(pos);
+}
+
+QHBoxLayout *TitleBar::createSlotLayout()
+{
+    QHBoxLayout *layout = new QHBoxLayout;
+    layout->setSpacing(4);
+    layout->setContentsMargins(0, 0, 0, 0);
+    return layout;
+}
+
+void TitleBar::trackInteractiveWidget(QWidget *widget)
+{
+    m_interactiveWidgets.insert(widget, QRegion());
+    widget->installEventFilter(this);
+    updateInteractiveRegion(widget);
+}
+
+void TitleBar::untrackInteractiveWidget(QObject *widget)
+{
+    auto it = m_interactiveWidgets.find(static_cast<QWidget *>(widget));
+    if (it == m_interactiveWidgets.end())
+        return;
+
+    const QRegion old = it.value();
+    m_interactiveWidgets.erase(it);
+    widget->removeEventFilter(this);
+    replaceInteractiveRegion(old, QRegion());
+}
+
+void TitleBar::updateInteractiveRegion(QWidget *widget)
+{
+    QRegion region;
+    if (widget->isVisibleTo(this))
     {
-        if (btn->isVisible())
-            width += btn->width();
+        if (widget == m_tabStrip)
+            region = m_tabStrip->interactiveRegion().translated(
+                m_tabStrip->pos());
+        else
+            region = widget->geometry();
     }
 
-    return (0 < pos.x() && pos.x() < this->width() - width);
+    QRegion &current = m_interactiveWidgets[widget];
+    if (current == region)
+        return;
+
+    const QRegion old = current;
+    current = region;
+    replaceInteractiveRegion(old, region);
+}
+
+void TitleBar::replaceInteractiveRegion(
+    const QRegion &oldRegion, const QRegion &newRegion)
+{
+    // Only the part that changed is touched, widgets overlapping the old
+    // area are added back.
+    m_interactiveRegion -= oldRegion;
+    m_interactiveRegion += newRegion;
+    if (oldRegion.isEmpty())
+        return;
+
+    for (auto it = m_interactiveWidgets.constBegin();
+         it != m_interactiveWidgets.constEnd(); ++it)
+    {
+        if (it.value().intersects(oldRegion))
+            m_interactiveRegion += it.value();
+    }
 }
 
 bool TitleBar::hasButtonPressed()
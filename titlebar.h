@@ -1,26 +1,66 @@
 #ifndef TITLEBAR_H
 #define TITLEBAR_H
 
+#include <QHash>
+#include <QIcon>
 #include <QLabel>
+#include <QPointer>
+#include <QRegion>
 #include <QWidget>
 
+#include "snapshottransition.h"
 #include "titlebarbutton.h"
+#include "titlebartabstrip.h"
+
+class QHBoxLayout;
 
 class TitleBar : public QWidget
 {
     Q_OBJECT
 public:
+    enum WidgetSlot
+    {
+        kLeftSlot = 0,
+        kCenterSlot,
+        kRightSlot
+    };
+
     explicit TitleBar(QWidget *parent = 0);
     virtual ~TitleBar() = default;
 
     void setDoubleClickEnabled(bool enable);
+    // Animates maximize/restore with a snapshot of the window.
+    void setMaxTransitionEnabled(bool enable);
+    // Created on first use, placed after the title.
+    TitleBarTabStrip *tabStrip();
+
+    // Adds |widget| to |slot|, the left slot follows the title and the right
+    // one precedes the buttons. Clicks on the widget no longer drag the
+    // window. removeWidget() hides it and leaves ownership to the caller.
+    void addWidget(QWidget *widget, WidgetSlot slot);
+    void removeWidget(QWidget *widget);
+
+    // Area of the buttons, slot widgets and tabs, kept up to date as they
+    // move, resize, show and hide.
+    QRegion interactiveRegion() const;
+
+    // Drops the icon pixmap and button caches while the window is parked,
+    // restoreResources() brings back what isn't rebuilt on paint.
+    void releaseResources();
+    void restoreResources();
+    // Bytes of the icon pixmap, the parsed button svgs aren't counted.
+    qint64 memoryUsage() const;
 
 public slots:
     void setTitle(const QString &title);
     void setIcon(const QIcon &icon);
 
+signals:
+    void windowStateChanged(Qt::WindowStates state);
+
 protected:
     virtual bool eventFilter(QObject *obj, QEvent *e) override;
+    virtual void childEvent(QChildEvent *event) override;
     virtual void mouseDoubleClickEvent(QMouseEvent *event) override;
     virtual void mousePressEvent(QMouseEvent *event) override;
     virtual void mouseMoveEvent(QMouseEvent *event) override;
@@ -32,14 +72,30 @@ private:
     bool isDragRegion(const QPoint &pos);
     bool hasButtonPressed();
     bool canDrag(const QPoint &pos);
+    QHBoxLayout *createSlotLayout();
+    void trackInteractiveWidget(QWidget *widget);
+    void untrackInteractiveWidget(QObject *widget);
+    void updateInteractiveRegion(QWidget *widget);
+    void replaceInteractiveRegion(
+        const QRegion &oldRegion, const QRegion &newRegion);
 
 private:
     MinimizeButton *m_minBtn;
     MaximizeButton *m_maxBtn;
     CloseButton *m_closeBtn;
     bool m_isDoubleClickedEnabled;
+    bool m_isMaxTransitionEnabled;
+    QPointer<SnapshotTransition> m_maxTransition;
     QLabel *m_iconLabel;
     QLabel *m_titleLabel;
+    QIcon m_icon;
+    QHBoxLayout *m_layout;
+    QHBoxLayout *m_leftLayout;
+    QHBoxLayout *m_centerLayout;
+    QHBoxLayout *m_rightLayout;
+    TitleBarTabStrip *m_tabStrip;
+    QHash<QWidget *, QRegion> m_interactiveWidgets;
+    QRegion m_interactiveRegion;
 };
 
 #endif  // TITLEBAR_H
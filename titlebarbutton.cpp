@@ -7,10 +7,43 @@
 #include <QPen>
 #include <QSvgRenderer>
 
-TitleBarButton::TitleBarButton(QWidget *parent) : QAbstractButton(parent)
+#include "chrometrace.h"
+#include "framelesshelper.h"
+#include "titlebarglyphs.h"
+
+// Fade durations of the hover transitions, pressing is instant like the
+// native caption buttons.
+constexpr int kHoverFadeInDuration = 80;
+constexpr int kHoverFadeOutDuration = 150;
+
+// Blends in premultiplied space so fading from a transparent background
+// doesn't pass through a darker color.
+QColor blendColor(const QColor &from, const QColor &to, qreal progress)
+{
+    const qreal fromAlpha = from.alphaF();
+    const qreal toAlpha = to.alphaF();
+    const qreal alpha = fromAlpha + (toAlpha - fromAlpha) * progress;
+    if (alpha <= 0.0)
+        return QColor(0, 0, 0, 0);
+
+    auto channel = [=](qreal fromValue, qreal toValue) {
+        const qreal a = fromValue * fromAlpha;
+        const qreal b = toValue * toAlpha;
+        return qBound<qreal>(0.0, (a + (b - a) * progress) / alpha, 1.0);
+    };
+    return QColor::fromRgbF(
+        channel(from.redF(), to.redF()), channel(from.greenF(), to.greenF()),
+        channel(from.blueF(), to.blueF()), alpha);
+}
+
+TitleBarButton::TitleBarButton(QWidget *parent)
+    : QAbstractButton(parent),
+      m_transitionStart(0),
+      m_transitionDuration(0),
+      m_transitionProgress(1.0)
 {
     setCursor(Qt::ArrowCursor);
-    setFixedSize(46, 32);
+    setFixedSize(kTitleBarButtonWidth, kTitleBarHeight);
 
     m_state = TitleBarButtonState::kNormal;
     m_normalColor = QColor(0, 0, 0);
@@ -22,15 +55,57 @@ TitleBarButton::TitleBarButton(QWidget *parent) : QAbstractButton(parent)
     m_pressedBgColor = QColor(0, 0, 0, 51);
 }
 
+TitleBarButton::~TitleBarButton()
+{
+    AnimationClock::instance()->stop(this);
+}
+
 void TitleBarButton::setState(TitleBarButtonState state)
 {
     if (m_state == state)
         return;
 
+    // fade from whatever is currently shown
+    getCurColors(m_fromColor, m_fromBgColor);
     m_state = state;
+
+    switch (state)
+    {
+        case TitleBarButtonState::kNormal:
+            m_transitionDuration = kHoverFadeOutDuration;
+            break;
+        case TitleBarButtonState::kHover:
+            m_transitionDuration = kHoverFadeInDuration;
+            break;
+        case TitleBarButtonState::kPressed:
+            m_transitionDuration = 0;
+            break;
+    }
+
+    AnimationClock *clock = AnimationClock::instance();
+    if (m_transitionDuration > 0 && isVisible())
+    {
+        m_transitionStart = clock->now();
+        m_transitionProgress = 0.0;
+        clock->start(this);
+    }
+    else
+    {
+        m_transitionProgress = 1.0;
+        clock->stop(this);
+    }
     update();
 }
 
+bool TitleBarButton::advance(qint64 msecs)
+{
+    m_transitionProgress = qMin<qreal>(
+        1.0, static_cast<qreal>(msecs - m_transitionStart) /
+                 m_transitionDuration);
+    update();
+    return m_transitionProgress < 1.0;
+}
+
 bool TitleBarButton::isPressed() const
 {
     return m_state == TitleBarButtonState::kPressed;
@@ -120,9 +195,35 @@ QColor TitleBarButton::getPressedBgColor() const
     return m_pressedBgColor;
 }
 
+void TitleBarButton::releaseResources() {}
+
 void TitleBarButton::getCurColors(QColor &color, QColor &bgColor) const
 {
-    switch (m_state)
+    getStateColors(m_state, color, bgColor);
+    if (m_transitionProgress >= 1.0)
+        return;
+
+    color = blendColor(m_fromColor, color, m_transitionProgress);
+    bgColor = blendColor(m_fromBgColor, bgColor, m_transitionProgress);
+}
+
+void TitleBarButton::setCaptionColors(CaptionButton button)
+{
+    const CaptionButtonColors normal = captionButtonColors(button, kNormal);
+    const CaptionButtonColors hover = captionButtonColors(button, kHover);
+    const CaptionButtonColors pressed = captionButtonColors(button, kPressed);
+    setNormalColor(normal.icon);
+    setNormalBgColor(normal.background);
+    setHoverColor(hover.icon);
+    setHoverBgColor(hover.background);
+    setPressedColor(pressed.icon);
+    setPressedBgColor(pressed.background);
+}
+
+void TitleBarButton::getStateColors(
+    TitleBarButtonState state, QColor &color, QColor &bgColor) const
+{
+    switch (state)
     {
         case TitleBarButtonState::kNormal:
             color = m_normalColor;
@@ -168,7 +269,19 @@ SvgTitleBarButton::SvgTitleBarButton(const QString &iconPath, QWidget *parent)
 
 void SvgTitleBarButton::setIcon(const QString &iconPath)
 {
-    QFile f(iconPath);
+    m_iconPath = iconPath;
+    loadIcon();
+    update();
+}
+
+void SvgTitleBarButton::releaseResources()
+{
+    m_svgDom.clear();
+}
+
+void SvgTitleBarButton::loadIcon()
+{
+    QFile f(m_iconPath);
     f.open(QFile::ReadOnly);
     m_svgDom.setContent(f.readAll());
     f.close();
@@ -177,6 +290,7 @@ void SvgTitleBarButton::setIcon(const QString &iconPath)
 void SvgTitleBarButton::paintEvent(QPaintEvent *event)
 {
     Q_UNUSED(event)
+    CHROME_TRACE_SCOPE("SvgTitleBarButton::paintEvent");
     QPainter painter(this);
     painter.setRenderHints(
         QPainter::Antialiasing | QPainter::SmoothPixmapTransform);
@@ -189,16 +303,25 @@ void SvgTitleBarButton::paintEvent(QPaintEvent *event)
     painter.drawRect(rect());
 
     // draw icon
+    if (m_svgDom.isNull())
+        loadIcon();
+    drawIcon(&painter, m_svgDom, color, QRectF(rect()));
+}
+
+void SvgTitleBarButton::drawIcon(
+    QPainter *painter, QDomDocument &svgDom, const QColor &color,
+    const QRectF &rect)
+{
     QString colorName = color.name();
-    QDomNodeList pathNodes = m_svgDom.elementsByTagName("path");
+    QDomNodeList pathNodes = svgDom.elementsByTagName("path");
     for (int i = 0; i < pathNodes.count(); ++i)
     {
         QDomElement element = pathNodes.at(i).toElement();
         element.setAttribute("stroke", colorName);
     }
 
-    QSvgRenderer render(m_svgDom.toByteArray());
-    render.render(&painter, QRectF(rect()));
+    QSvgRenderer render(svgDom.toByteArray());
+    render.render(painter, rect);
 }
 
 MinimizeButton::MinimizeButton(QWidget *parent) : TitleBarButton(parent) {}
@@ -206,6 +329,7 @@ MinimizeButton::MinimizeButton(QWidget *parent) : TitleBarButton(parent) {}
 void MinimizeButton::paintEvent(QPaintEvent *event)
 {
     Q_UNUSED(event)
+    CHROME_TRACE_SCOPE("MinimizeButton::paintEvent");
     QPainter painter(this);
     QColor color, bgColor;
     getCurColors(color, bgColor);
@@ -216,11 +340,13 @@ void MinimizeButton::paintEvent(QPaintEvent *event)
     painter.drawRect(rect());
 
     // draw icon
-    painter.setBrush(Qt::NoBrush);
-    QPen pen(color, 1);
-    pen.setCosmetic(true);
-    painter.setPen(pen);
-    painter.drawLine(18, 16, 28, 16);
+    drawIcon(&painter, color, devicePixelRatioF());
+}
+
+void MinimizeButton::drawIcon(
+    QPainter *painter, const QColor &color, qreal dpr)
+{
+    drawTitleBarGlyph(painter, TitleBarGlyph::kMinimize, color, dpr);
 }
 
 MaximizeButton::MaximizeButton(QWidget *parent)
@@ -240,6 +366,7 @@ void MaximizeButton::setMaxState(bool isMax)
 void MaximizeButton::paintEvent(QPaintEvent *event)
 {
     Q_UNUSED(event)
+    CHROME_TRACE_SCOPE("MaximizeButton::paintEvent");
     QPainter painter(this);
     QColor color, bgColor;
     getCurColors(color, bgColor);
@@ -250,37 +377,19 @@ void MaximizeButton::paintEvent(QPaintEvent *event)
     painter.drawRect(rect());
 
     // draw icon
-    painter.setBrush(Qt::NoBrush);
-    QPen pen(color, 1);
-    pen.setCosmetic(true);
-    painter.setPen(pen);
-
-    qreal r = devicePixelRatioF();
-    painter.scale(1 / r, 1 / r);
-    if (!m_isMax)
-    {
-        painter.drawRect(18 * r, 11 * r, 10 * r, 10 * r);
-    }
-    else
-    {
-        painter.drawRect(18 * r, 13 * r, 8 * r, 8 * r);
-        int x0 = static_cast<int>(18 * r) + static_cast<int>(2 * r);
-        int y0 = 13 * r;
-        int dw = 2 * r;
-        QPainterPath path = QPainterPath(QPointF(x0, y0));
-        path.lineTo(x0, y0 - dw);
-        path.lineTo(x0 + 8 * r, y0 - dw);
-        path.lineTo(x0 + 8 * r, y0 - dw + 8 * r);
-        path.lineTo(x0 + 8 * r - dw, y0 - dw + 8 * r);
-        painter.drawPath(path);
-    }
+    drawIcon(&painter, color, m_isMax, devicePixelRatioF());
+}
+
+void MaximizeButton::drawIcon(
+    QPainter *painter, const QColor &color, bool isMax, qreal dpr)
+{
+    drawTitleBarGlyph(
+        painter, isMax ? TitleBarGlyph::kRestore : TitleBarGlyph::kMaximize,
+        color, dpr);
 }
 
 CloseButton::CloseButton(const QString &iconPath, QWidget *parent)
     : SvgTitleBarButton(iconPath, parent)
 {
-    setHoverColor(Qt::white);
-    setPressedColor(Qt::white);
-    setHoverBgColor(QColor(232, 17, 35));
-    setPressedBgColor(QColor(241, 112, 122));
+    setCaptionColors(CaptionButton::kClose);
 }
@@ -6,19 +6,17 @@
 #include <QDomDocument>
 #include <QString>
 
-enum TitleBarButtonState
-{
-    kNormal = 0,
-    kHover,
-    kPressed
-};
+#include "animationclock.h"
+#include "framelesshelper.h"
 
-class TitleBarButton : public QAbstractButton
+class QPainter;
+
+class TitleBarButton : public QAbstractButton, public ClockedAnimation
 {
     Q_OBJECT
 public:
     TitleBarButton(QWidget *parent = nullptr);
-    virtual ~TitleBarButton() = default;
+    virtual ~TitleBarButton();
 
     bool isPressed() const;
 
@@ -42,6 +40,14 @@ public:
 
     void getCurColors(QColor &color, QColor &bgColor) const;
 
+    // Uses the shared caption button palette for every state.
+    void setCaptionColors(CaptionButton button);
+
+    virtual bool advance(qint64 msecs) override;
+
+    // Drops caches that can be rebuilt on the next paint.
+    virtual void releaseResources();
+
 protected:
     virtual void enterEvent(QEvent *event) override;
     virtual void leaveEvent(QEvent *event) override;
@@ -49,6 +55,10 @@ protected:
 
     void setState(TitleBarButtonState state);
 
+private:
+    void getStateColors(
+        TitleBarButtonState state, QColor &color, QColor &bgColor) const;
+
 private:
     TitleBarButtonState m_state;
     // Icon color
@@ -59,6 +69,12 @@ private:
     QColor m_normalBgColor;
     QColor m_hoverBgColor;
     QColor m_pressedBgColor;
+    // colors faded from on a state change
+    QColor m_fromColor;
+    QColor m_fromBgColor;
+    qint64 m_transitionStart;
+    int m_transitionDuration;
+    qreal m_transitionProgress;
 };
 
 class SvgTitleBarButton : public TitleBarButton
@@ -69,10 +85,21 @@ public:
 
     void setIcon(const QString &iconPath);
 
+    // Drops the parsed svg, --memory-check measures what that frees.
+    virtual void releaseResources() override;
+
+    static void drawIcon(
+        QPainter *painter, QDomDocument &svgDom, const QColor &color,
+        const QRectF &rect);
+
 protected:
     virtual void paintEvent(QPaintEvent *event) override;
 
 private:
+    void loadIcon();
+
+private:
+    QString m_iconPath;
     QDomDocument m_svgDom;
 };
 
@@ -82,6 +109,8 @@ public:
     MinimizeButton(QWidget *parent = nullptr);
     virtual ~MinimizeButton() = default;
 
+    static void drawIcon(QPainter *painter, const QColor &color, qreal dpr);
+
 protected:
     virtual void paintEvent(QPaintEvent *event) override;
 };
@@ -94,6 +123,9 @@ public:
 
     void setMaxState(bool isMax);
 
+    static void drawIcon(
+        QPainter *painter, const QColor &color, bool isMax, qreal dpr);
+
 protected:
     virtual void paintEvent(QPaintEvent *event) override;
 
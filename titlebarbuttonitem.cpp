@@ -0,0 +1,165 @@
+#include "titlebarbuttonitem.h"
+
+#include <QDomDocument>
+#include <QFile>
+#include <QMouseEvent>
+#include <QMutex>
+#include <QPainter>
+#include <QQuickWindow>
+
+#include "chrometrace.h"
+#include "framelesshelper.h"
+
+// The close svg is parsed once for all items. Painted items may be rendered
+// outside the GUI thread and drawing recolors the DOM, so it is locked.
+static void drawCloseIcon(
+    QPainter *painter, const QColor &color, const QRectF &rect)
+{
+    static QMutex mutex;
+    static QDomDocument svgDom;
+    static bool isLoaded = false;
+    QMutexLocker locker(&mutex);
+    if (!isLoaded)
+    {
+        isLoaded = true;
+        QFile f(":/btn/res/close.svg");
+        if (f.open(QFile::ReadOnly))
+            svgDom.setContent(f.readAll());
+        else
+            qWarning("TitleBarButtonItem: can't open %s", qPrintable(
+                f.fileName()));
+    }
+    if (!svgDom.isNull())
+        SvgTitleBarButton::drawIcon(painter, svgDom, color, rect);
+}
+
+TitleBarButtonItem::TitleBarButtonItem(QQuickItem *parent)
+    : QQuickPaintedItem(parent), m_role(Minimize), m_state(kNormal)
+{
+    setImplicitSize(kTitleBarButtonWidth, kTitleBarHeight);
+    setAcceptedMouseButtons(Qt::LeftButton);
+    setAcceptHoverEvents(true);
+}
+
+TitleBarButtonItem::Role TitleBarButtonItem::role() const
+{
+    return m_role;
+}
+
+void TitleBarButtonItem::setRole(Role role)
+{
+    if (m_role == role)
+        return;
+
+    m_role = role;
+    update();
+    emit roleChanged();
+}
+
+void TitleBarButtonItem::paint(QPainter *painter)
+{
+    CHROME_TRACE_SCOPE("TitleBarButtonItem::paint");
+    // same palette as the buttons of TitleBar
+    const CaptionButtonColors colors =
+        captionButtonColors(static_cast<CaptionButton>(m_role), m_state);
+    const QColor &color = colors.icon;
+    painter->fillRect(boundingRect(), colors.background);
+
+    const qreal dpr = window() ? window()->effectiveDevicePixelRatio() : 1.0;
+    switch (m_role)
+    {
+        case Minimize:
+            MinimizeButton::drawIcon(painter, color, dpr);
+            break;
+        case Maximize:
+            MaximizeButton::drawIcon(
+                painter, color,
+                window() && window()->windowStates().testFlag(
+                                Qt::WindowMaximized),
+                dpr);
+            break;
+        case Close:
+            drawCloseIcon(painter, color, boundingRect());
+            break;
+    }
+}
+
+void TitleBarButtonItem::hoverEnterEvent(QHoverEvent *event)
+{
+    Q_UNUSED(event)
+    if (m_state == kNormal)
+        setState(kHover);
+}
+
+void TitleBarButtonItem::hoverLeaveEvent(QHoverEvent *event)
+{
+    Q_UNUSED(event)
+    if (m_state == kHover)
+        setState(kNormal);
+}
+
+void TitleBarButtonItem::mousePressEvent(QMouseEvent *event)
+{
+    Q_UNUSED(event)
+    setState(kPressed);
+}
+
+void TitleBarButtonItem::mouseReleaseEvent(QMouseEvent *event)
+{
+    const bool inside = contains(event->localPos());
+    setState(inside ? kHover : kNormal);
+    if (inside)
+        trigger();
+}
+
+void TitleBarButtonItem::itemChange(
+    ItemChange change, const ItemChangeData &value)
+{
+    if (change == ItemSceneChange)
+    {
+        // the maximize glyph follows the window state
+        disconnect(m_windowStateConnection);
+        if (value.window)
+        {
+            m_windowStateConnection = connect(
+                value.window, &QWindow::windowStateChanged, this, [this]() {
+                    if (m_role == Maximize)
+                        update();
+                });
+        }
+    }
+    QQuickPaintedItem::itemChange(change, value);
+}
+
+void TitleBarButtonItem::setState(TitleBarButtonState state)
+{
+    if (m_state == state)
+        return;
+
+    m_state = state;
+    update();
+}
+
+void TitleBarButtonItem::trigger()
+{
+    emit clicked();
+    QQuickWindow *window = this->window();
+    if (!window)
+        return;
+
+    switch (m_role)
+    {
+        case Minimize:
+            window->showMinimized();
+            break;
+        case Maximize:
+            if (window->windowStates().testFlag(Qt::WindowMaximized))
+                window->showNormal();
+            else
+                window->showMaximized();
+            break;
+        case Close:
+            window->close();
+            break;
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef TITLEBARBUTTONITEM_H
+#define TITLEBARBUTTONITEM_H
+
+#include <QQuickPaintedItem>
+
+#include "titlebarbutton.h"
+
+// Title bar button for FramelessQuickWindow, drawn with the glyphs and
+// colors of the widget buttons. It is a painted item, so hover and press
+// changes only re-render its own texture in the scene graph, which also
+// works with the software backend.
+class TitleBarButtonItem : public QQuickPaintedItem
+{
+    Q_OBJECT
+    Q_PROPERTY(Role role READ role WRITE setRole NOTIFY roleChanged)
+public:
+    // QML needs enum values starting with an upper case letter. The values
+    // match CaptionButton.
+    enum Role
+    {
+        Minimize = static_cast<int>(CaptionButton::kMinimize),
+        Maximize = static_cast<int>(CaptionButton::kMaximize),
+        Close = static_cast<int>(CaptionButton::kClose)
+    };
+    Q_ENUM(Role)
+
+    explicit TitleBarButtonItem(QQuickItem *parent = nullptr);
+
+    Role role() const;
+    void setRole(Role role);
+
+    virtual void paint(QPainter *painter) override;
+
+signals:
+    void roleChanged();
+    void clicked();
+
+protected:
+    virtual void hoverEnterEvent(QHoverEvent *event) override;
+    virtual void hoverLeaveEvent(QHoverEvent *event) override;
+    virtual void mousePressEvent(QMouseEvent *event) override;
+    virtual void mouseReleaseEvent(QMouseEvent *event) override;
+    virtual void itemChange(
+        ItemChange change, const ItemChangeData &value) override;
+
+private:
+    void setState(TitleBarButtonState state);
+    void trigger();
+
+private:
+    Role m_role;
+    TitleBarButtonState m_state;
+    QMetaObject::Connection m_windowStateConnection;
+};
+
+#endif  // TITLEBARBUTTONITEM_H
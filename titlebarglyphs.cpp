@@ -0,0 +1,127 @@
+#include "titlebarglyphs.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QPainter>
+#include <QPen>
+
+constexpr int kGlyphCount = static_cast<int>(TitleBarGlyph::kGlyphCount);
+
+// Logical coordinates are snapped to the device pixel they fall in, at
+// compile time for the common scales and at run time for the others. That
+// is where the aliased cosmetic pen of the former drawing put them, so the
+// glyphs keep their pixels.
+template <int kPercent>
+struct FixedScale
+{
+    constexpr int operator()(int logical) const
+    {
+        return logical * kPercent / 100;
+    }
+};
+
+struct RuntimeScale
+{
+    qreal dpr;
+    int operator()(int logical) const
+    {
+        return static_cast<int>(logical * dpr);
+    }
+};
+
+constexpr TitleBarGlyphGeometry lineGeometry(int x0, int x1, int y)
+{
+    return {{QLine(x0, y, x1, y)}, 1};
+}
+
+constexpr TitleBarGlyphGeometry boxGeometry(int x0, int y0, int x1, int y1)
+{
+    return {
+        {QLine(x0, y0, x1, y0), QLine(x1, y0, x1, y1), QLine(x1, y1, x0, y1),
+         QLine(x0, y1, x0, y0)},
+        4};
+}
+
+// front box plus the visible part of the box behind it, which ends at
+// |backEndX| below its right edge
+constexpr TitleBarGlyphGeometry restoreGeometry(
+    int x0, int y0, int x1, int y1, int backX0, int backY0, int backX1,
+    int backY1, int backEndX)
+{
+    return {
+        {QLine(x0, y0, x1, y0), QLine(x1, y0, x1, y1), QLine(x1, y1, x0, y1),
+         QLine(x0, y1, x0, y0), QLine(backX0, y0, backX0, backY0),
+         QLine(backX0, backY0, backX1, backY0),
+         QLine(backX1, backY0, backX1, backY1),
+         QLine(backX1, backY1, backEndX, backY1)},
+        8};
+}
+
+// Same pixels as the former drawing of MaximizeButton. Its boxes went
+// through drawRect(int, int, int, int), which truncated position and size
+// separately, so the right and bottom edges are s(x) + s(width) and not
+// s(x + width). The box behind is offset by whole device pixels from the
+// front box, as the path was.
+template <typename Scale>
+constexpr TitleBarGlyphGeometry buildGlyphGeometry(
+    TitleBarGlyph glyph, Scale s)
+{
+    return glyph == TitleBarGlyph::kMinimize
+               ? lineGeometry(s(18), s(28), s(16))
+               : glyph == TitleBarGlyph::kMaximize
+                     ? boxGeometry(s(18), s(11), s(18) + s(10), s(11) + s(10))
+                     : restoreGeometry(
+                           s(18), s(13), s(18) + s(8), s(13) + s(8),
+                           s(18) + s(2), s(13) - s(2), s(18) + s(2) + s(8),
+                           s(13) - s(2) + s(8), s(18) + s(8));
+}
+
+template <int kPercent>
+struct GlyphTable
+{
+    static constexpr TitleBarGlyphGeometry glyphs[kGlyphCount] = {
+        buildGlyphGeometry(TitleBarGlyph::kMinimize, FixedScale<kPercent>()),
+        buildGlyphGeometry(TitleBarGlyph::kMaximize, FixedScale<kPercent>()),
+        buildGlyphGeometry(TitleBarGlyph::kRestore, FixedScale<kPercent>())};
+};
+
+template <int kPercent>
+constexpr TitleBarGlyphGeometry GlyphTable<kPercent>::glyphs[kGlyphCount];
+
+TitleBarGlyphGeometry titleBarGlyphGeometry(TitleBarGlyph glyph, qreal dpr)
+{
+    const int index = static_cast<int>(glyph);
+    if (qFuzzyCompare(dpr, 1.0))
+        return GlyphTable<100>::glyphs[index];
+    if (qFuzzyCompare(dpr, 1.25))
+        return GlyphTable<125>::glyphs[index];
+    if (qFuzzyCompare(dpr, 1.5))
+        return GlyphTable<150>::glyphs[index];
+    if (qFuzzyCompare(dpr, 2.0))
+        return GlyphTable<200>::glyphs[index];
+
+    // Painted items may be rendered outside the GUI thread.
+    static QMutex mutex;
+    static QHash<qint64, TitleBarGlyphGeometry> cache;
+    const qint64 key = qRound64(dpr * 10000) * kGlyphCount + index;
+    QMutexLocker locker(&mutex);
+    auto it = cache.find(key);
+    if (it == cache.end())
+        it = cache.insert(key, buildGlyphGeometry(glyph, RuntimeScale{dpr}));
+    return it.value();
+}
+
+void drawTitleBarGlyph(
+    QPainter *painter, TitleBarGlyph glyph, const QColor &color, qreal dpr)
+{
+    const TitleBarGlyphGeometry geometry = titleBarGlyphGeometry(glyph, dpr);
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing, false);
+    painter->setBrush(Qt::NoBrush);
+    QPen pen(color, 1);
+    pen.setCosmetic(true);
+    painter->setPen(pen);
+    painter->scale(1 / dpr, 1 / dpr);
+    painter->drawLines(geometry.lines, geometry.lineCount);
+    painter->restore();
+}
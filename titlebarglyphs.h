@@ -0,0 +1,36 @@
+#ifndef TITLEBARGLYPHS_H
+#define TITLEBARGLYPHS_H
+
+#include <QColor>
+#include <QLine>
+
+class QPainter;
+
+enum class TitleBarGlyph
+{
+    kMinimize = 0,
+    kMaximize,
+    kRestore,
+    kGlyphCount
+};
+
+constexpr int kMaxGlyphLines = 8;
+
+// Outline of a caption button glyph as one device pixel wide lines, in
+// device pixels of a 46x32 button and snapped to the pixel grid.
+struct TitleBarGlyphGeometry
+{
+    QLine lines[kMaxGlyphLines];
+    int lineCount;
+};
+
+// Geometry of |glyph| at |dpr|. The 100, 125, 150 and 200 percent scales
+// are tables built at compile time, other scales are computed once and
+// cached.
+TitleBarGlyphGeometry titleBarGlyphGeometry(TitleBarGlyph glyph, qreal dpr);
+
+// Draws |glyph| in button coordinates with a crisp device pixel pen.
+void drawTitleBarGlyph(
+    QPainter *painter, TitleBarGlyph glyph, const QColor &color, qreal dpr);
+
+#endif  // TITLEBARGLYPHS_H
@@ -0,0 +1,352 @@
+#include "titlebartabstrip.h"
+
+#include <QMouseEvent>
+#include <QPainter>
+#include <QWheelEvent>
+
+#include "chrometrace.h"
+
+constexpr int kTabWidth = 160;
+// Gap in front of every tab, it stays a draggable caption.
+constexpr int kTabSpacing = 8;
+constexpr int kTabStride = kTabWidth + kTabSpacing;
+constexpr int kTabTopMargin = 4;
+constexpr int kTabTextPadding = 10;
+
+TitleBarTabStrip::TitleBarTabStrip(QWidget *parent)
+    : QWidget(parent),
+      m_currentIndex(-1),
+      m_hoveredIndex(-1),
+      m_draggedIndex(-1),
+      m_scrollOffset(0)
+{
+    QFont font("Segoe UI");
+    font.setPixelSize(12);
+    setFont(font);
+    setMouseTracking(true);
+    setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred);
+}
+
+int TitleBarTabStrip::addTab(const QString &text)
+{
+    return insertTab(m_tabs.size(), text);
+}
+
+int TitleBarTabStrip::insertTab(int index, const QString &text)
+{
+    index = qBound(0, index, m_tabs.size());
+    m_tabs.insert(index, text);
+    if (m_currentIndex >= index)
+        ++m_currentIndex;
+    m_draggedIndex = -1;
+    updateGeometry();
+    update();
+    emit interactiveRegionChanged();
+    if (m_currentIndex < 0)
+        setCurrentIndex(index);
+    return index;
+}
+
+void TitleBarTabStrip::removeTab(int index)
+{
+    if (index < 0 || index >= m_tabs.size())
+        return;
+
+    m_tabs.remove(index);
+    m_draggedIndex = -1;
+    m_hoveredIndex = -1;
+    setScrollOffset(m_scrollOffset);
+    updateGeometry();
+    update();
+    emit interactiveRegionChanged();
+
+    if (index < m_currentIndex)
+    {
+        --m_currentIndex;
+    }
+    else if (index == m_currentIndex)
+    {
+        m_currentIndex = qMin(m_currentIndex, m_tabs.size() - 1);
+        emit currentChanged(m_currentIndex);
+    }
+}
+
+void TitleBarTabStrip::clear()
+{
+    if (m_tabs.isEmpty())
+        return;
+
+    m_tabs.clear();
+    m_currentIndex = -1;
+    m_hoveredIndex = -1;
+    m_draggedIndex = -1;
+    m_scrollOffset = 0;
+    updateGeometry();
+    update();
+    emit interactiveRegionChanged();
+    emit currentChanged(-1);
+}
+
+int TitleBarTabStrip::count() const
+{
+    return m_tabs.size();
+}
+
+QString TitleBarTabStrip::tabText(int index) const
+{
+    return m_tabs.value(index);
+}
+
+void TitleBarTabStrip::setTabText(int index, const QString &text)
+{
+    if (index < 0 || index >= m_tabs.size())
+        return;
+
+    m_tabs[index] = text;
+    update(tabRect(index));
+}
+
+int TitleBarTabStrip::currentIndex() const
+{
+    return m_currentIndex;
+}
+
+void TitleBarTabStrip::setCurrentIndex(int index)
+{
+    if (index < 0 || index >= m_tabs.size() || index == m_currentIndex)
+        return;
+
+    update(tabRect(m_currentIndex));
+    m_currentIndex = index;
+    update(tabRect(m_currentIndex));
+    emit currentChanged(index);
+}
+
+int TitleBarTabStrip::tabAt(const QPoint &pos) const
+{
+    const int x = pos.x() + m_scrollOffset - kTabSpacing;
+    if (x < 0 || pos.y() < kTabTopMargin || pos.y() >= height())
+        return -1;
+
+    const int index = x / kTabStride;
+    if (index >= m_tabs.size() || x - index * kTabStride >= kTabWidth)
+        return -1;
+    return index;
+}
+
+QRect TitleBarTabStrip::tabRect(int index) const
+{
+    if (index < 0 || index >= m_tabs.size())
+        return QRect();
+
+    return QRect(
+        kTabSpacing + index * kTabStride - m_scrollOffset, kTabTopMargin,
+        kTabWidth, height() - kTabTopMargin);
+}
+
+QRegion TitleBarTabStrip::interactiveRegion() const
+{
+    QRegion region;
+    const int last = lastVisibleIndex();
+    for (int i = firstVisibleIndex(); i <= last; ++i)
+        region += tabRect(i).intersected(rect());
+    return region;
+}
+
+int TitleBarTabStrip::scrollOffset() const
+{
+    return m_scrollOffset;
+}
+
+void TitleBarTabStrip::setScrollOffset(int offset)
+{
+    offset = qBound(0, offset, maxScrollOffset());
+    if (offset == m_scrollOffset)
+        return;
+
+    m_scrollOffset = offset;
+    m_hoveredIndex = -1;
+    update();
+    emit interactiveRegionChanged();
+}
+
+void TitleBarTabStrip::ensureVisible(int index)
+{
+    const QRect rect = tabRect(index);
+    if (rect.isNull())
+        return;
+
+    if (rect.left() < kTabSpacing)
+        setScrollOffset(m_scrollOffset + rect.left() - kTabSpacing);
+    else if (rect.right() >= width() - kTabSpacing)
+        setScrollOffset(m_scrollOffset + rect.right() + 1 + kTabSpacing -
+                        width());
+}
+
+QSize TitleBarTabStrip::sizeHint() const
+{
+    return QSize(contentWidth(), 32);
+}
+
+QSize TitleBarTabStrip::minimumSizeHint() const
+{
+    return QSize(qMin(contentWidth(), kTabStride + kTabSpacing), 32);
+}
+
+void TitleBarTabStrip::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event)
+    CHROME_TRACE_SCOPE("TitleBarTabStrip::paintEvent");
+    if (m_tabs.isEmpty())
+        return;
+
+    const int first = firstVisibleIndex();
+    const int last = lastVisibleIndex();
+
+    QPainter painter(this);
+    painter.setPen(Qt::NoPen);
+    const QFontMetrics metrics = fontMetrics();
+    for (int i = first; i <= last; ++i)
+    {
+        const QRect rect = tabRect(i);
+        if (i == m_currentIndex)
+            painter.setBrush(QColor(0, 100, 182, 40));
+        else if (i == m_hoveredIndex)
+            painter.setBrush(QColor(0, 0, 0, 28));
+        else
+            painter.setBrush(QColor(0, 0, 0, 12));
+        painter.drawRect(rect);
+
+        const QRect textRect =
+            rect.adjusted(kTabTextPadding, 0, -kTabTextPadding, 0);
+        painter.setPen(Qt::black);
+        painter.drawText(
+            textRect, Qt::AlignLeft | Qt::AlignVCenter,
+            metrics.elidedText(m_tabs.at(i), Qt::ElideRight, textRect.width()));
+        painter.setPen(Qt::NoPen);
+    }
+}
+
+void TitleBarTabStrip::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    setScrollOffset(m_scrollOffset);
+    emit interactiveRegionChanged();
+}
+
+void TitleBarTabStrip::leaveEvent(QEvent *event)
+{
+    Q_UNUSED(event)
+    setHoveredIndex(-1);
+}
+
+void TitleBarTabStrip::mousePressEvent(QMouseEvent *event)
+{
+    const int index = tabAt(event->pos());
+    if (index < 0)
+    {
+        // let the title bar drag the window
+        event->ignore();
+        return;
+    }
+
+    if (event->button() != Qt::LeftButton)
+        return;
+
+    setCurrentIndex(index);
+    m_draggedIndex = index;
+}
+
+void TitleBarTabStrip::mouseMoveEvent(QMouseEvent *event)
+{
+    if (m_draggedIndex < 0)
+    {
+        setHoveredIndex(tabAt(event->pos()));
+        // a press on a gap drags the window from the title bar
+        event->ignore();
+        return;
+    }
+
+    // The mouse is grabbed, so it can be far past either edge. The tab
+    // stops at the first or last one in view.
+    const int x = event->pos().x() + m_scrollOffset - kTabSpacing;
+    moveDraggedTab(
+        qBound(firstVisibleIndex(), x / kTabStride, lastVisibleIndex()));
+}
+
+void TitleBarTabStrip::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (m_draggedIndex < 0)
+    {
+        event->ignore();
+        return;
+    }
+
+    m_draggedIndex = -1;
+    setHoveredIndex(tabAt(event->pos()));
+}
+
+void TitleBarTabStrip::mouseDoubleClickEvent(QMouseEvent *event)
+{
+    // double clicking a gap maximizes like the rest of the title bar
+    if (tabAt(event->pos()) < 0)
+        event->ignore();
+}
+
+void TitleBarTabStrip::wheelEvent(QWheelEvent *event)
+{
+    if (maxScrollOffset() == 0)
+    {
+        event->ignore();
+        return;
+    }
+
+    const QPoint delta = event->angleDelta();
+    setScrollOffset(
+        m_scrollOffset - (delta.x() != 0 ? delta.x() : delta.y()));
+    setHoveredIndex(tabAt(event->position().toPoint()));
+}
+
+int TitleBarTabStrip::contentWidth() const
+{
+    return m_tabs.size() * kTabStride + kTabSpacing;
+}
+
+int TitleBarTabStrip::maxScrollOffset() const
+{
+    return qMax(0, contentWidth() - width());
+}
+
+int TitleBarTabStrip::firstVisibleIndex() const
+{
+    return qMax(0, (m_scrollOffset - kTabSpacing) / kTabStride);
+}
+
+int TitleBarTabStrip::lastVisibleIndex() const
+{
+    return qMin(m_tabs.size() - 1, (m_scrollOffset + width()) / kTabStride);
+}
+
+void TitleBarTabStrip::setHoveredIndex(int index)
+{
+    if (index == m_hoveredIndex)
+        return;
+
+    update(tabRect(m_hoveredIndex));
+    m_hoveredIndex = index;
+    update(tabRect(m_hoveredIndex));
+}
+
+void TitleBarTabStrip::moveDraggedTab(int to)
+{
+    const int from = m_draggedIndex;
+    if (to == from)
+        return;
+
+    // one block move of the tabs in between, however far it goes
+    m_tabs.move(from, to);
+    m_draggedIndex = to;
+    m_currentIndex = to;
+    update(tabRect(from).united(tabRect(to)));
+    emit tabMoved(from, to);
+}
@@ -0,0 +1,78 @@
+#ifndef TITLEBARTABSTRIP_H
+#define TITLEBARTABSTRIP_H
+
+#include <QRegion>
+#include <QString>
+#include <QVector>
+#include <QWidget>
+
+// Browser style tabs painted inside the title bar. Tabs have a fixed width
+// and are laid out arithmetically, so painting, hit testing, scrolling and
+// reordering only touch the visible tabs however many there are. Mouse
+// events in the gaps between tabs are ignored and reach the title bar,
+// which keeps them draggable.
+class TitleBarTabStrip : public QWidget
+{
+    Q_OBJECT
+public:
+    explicit TitleBarTabStrip(QWidget *parent = nullptr);
+
+    int addTab(const QString &text);
+    int insertTab(int index, const QString &text);
+    void removeTab(int index);
+    void clear();
+    int count() const;
+
+    QString tabText(int index) const;
+    void setTabText(int index, const QString &text);
+
+    int currentIndex() const;
+
+    // Returns -1 outside of the tabs, including the gaps between them.
+    int tabAt(const QPoint &pos) const;
+    QRect tabRect(int index) const;
+    // Union of the visible tabs, what the title bar must not drag from.
+    QRegion interactiveRegion() const;
+
+    int scrollOffset() const;
+    void setScrollOffset(int offset);
+    void ensureVisible(int index);
+
+    virtual QSize sizeHint() const override;
+    virtual QSize minimumSizeHint() const override;
+
+public slots:
+    void setCurrentIndex(int index);
+
+signals:
+    void currentChanged(int index);
+    void tabMoved(int from, int to);
+    void interactiveRegionChanged();
+
+protected:
+    virtual void paintEvent(QPaintEvent *event) override;
+    virtual void resizeEvent(QResizeEvent *event) override;
+    virtual void leaveEvent(QEvent *event) override;
+    virtual void mousePressEvent(QMouseEvent *event) override;
+    virtual void mouseMoveEvent(QMouseEvent *event) override;
+    virtual void mouseReleaseEvent(QMouseEvent *event) override;
+    virtual void mouseDoubleClickEvent(QMouseEvent *event) override;
+    virtual void wheelEvent(QWheelEvent *event) override;
+
+private:
+    int contentWidth() const;
+    int maxScrollOffset() const;
+    int firstVisibleIndex() const;
+    int lastVisibleIndex() const;
+    void setHoveredIndex(int index);
+    void moveDraggedTab(int to);
+
+private:
+    QVector<QString> m_tabs;
+    int m_currentIndex;
+    int m_hoveredIndex;
+    int m_draggedIndex;
+    int m_scrollOffset;
+};
+
+#endif  // TITLEBARTABSTRIP_H